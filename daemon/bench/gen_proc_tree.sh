@@ -0,0 +1,87 @@
+#!/bin/sh
+#
+# Copyright (C) 2025-2026 VelocityFox22
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Build a synthetic /proc tree for proc_bench
+# Usage: gen_proc_tree.sh <dir> [process count]
+#
+# The mix roughly follows a busy device: kernel threads with an empty
+# cmdline, native daemons, and app processes with :service children.
+# com.mobile.legends is placed near the end, after a com.mobile.legends.helper
+# decoy that a substring match would pick instead.
+#
+# Run as root, app processes are owned by their app UID and matching lines
+# are written to <dir>.packages.list. Copying that over
+# /data/system/packages.list (on a host, never on a device) lets pidof
+# narrow the scan by UID the way it does on a phone.
+
+ROOT="$1"
+COUNT="${2:-2000}"
+
+if [ -z "$ROOT" ]; then
+	echo "Usage: $0 <dir> [process count]" >&2
+	exit 1
+fi
+
+rm -rf "$ROOT"
+mkdir -p "$ROOT" || exit 1
+[ "$(id -u)" -eq 0 ] && : >"$ROOT.packages.list"
+
+# Non-PID entries are listed by the real /proc too
+mkdir -p "$ROOT/self" "$ROOT/sys"
+: >"$ROOT/uptime"
+
+# <pid> <comm> <cmdline, arguments separated by |> [app UID]
+proc() {
+	mkdir "$ROOT/$1"
+	printf '%s\n' "$2" >"$ROOT/$1/comm"
+	printf '%s' "$3" | tr '|' '\000' >"$ROOT/$1/cmdline"
+	[ -n "$4" ] && [ "$(id -u)" -eq 0 ] && chown -R "$4" "$ROOT/$1"
+}
+
+# <pid> <package> <process suffix> <app UID>
+app() {
+	[ -z "$3" ] && [ "$(id -u)" -eq 0 ] &&
+		echo "$2 $4 0 /data/user/0/$2 default:targetSdkVersion=34 none" >>"$ROOT.packages.list"
+	proc "$1" "$(app_comm "$2$3")" "$2$3" "$4"
+}
+
+# Zygote keeps the last 15 characters of long package names in comm
+app_comm() {
+	name="$1"
+	[ ${#name} -gt 15 ] && name=$(printf '%s' "$name" | tail -c 15)
+	printf '%s' "$name"
+}
+
+pid=1
+while [ "$pid" -le "$COUNT" ]; do
+	if [ "$pid" -le $((COUNT / 4)) ]; then
+		proc "$pid" "kworker/$pid" ""
+	elif [ "$pid" -le $((COUNT / 2)) ]; then
+		proc "$pid" "vendor.svc$pid" "/vendor/bin/hw/vendor.svc$pid|--service"
+	elif [ "$pid" -eq $((COUNT - 20)) ]; then
+		app "$pid" com.mobile.legends.helper "" 19998
+	elif [ "$pid" -eq $((COUNT - 10)) ]; then
+		app "$pid" com.mobile.legends "" 19999
+	elif [ "$pid" -eq $((COUNT - 9)) ]; then
+		app "$pid" com.mobile.legends :UnityKillsMe 19999
+	elif [ $((pid % 2)) -eq 0 ]; then
+		app "$pid" "com.vendor.app$((pid - 1))" :svc $((10000 + pid - 1))
+	else
+		app "$pid" "com.vendor.app$pid" "" $((10000 + pid))
+	fi
+	pid=$((pid + 1))
+done
@@ -0,0 +1,36 @@
+LOCAL_PATH := $(call my-dir)
+
+# Not part of the module, build with:
+#   ndk-build NDK_PROJECT_PATH=./daemon/bench
+include $(CLEAR_VARS)
+LOCAL_MODULE := proc_bench
+LOCAL_SRC_FILES := \
+    ../proc_bench.c \
+    ../../src/process_utils.c \
+    ../../src/proc_parse.c \
+    ../../src/nusantara_log.c \
+    ../../src/misc_utils.c \
+    ../../src/file_utils.c \
+    ../../src/cmd_utils.c \
+    ../../src/shell_worker.c \
+    ../../src/notify_dispatcher.c
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/../../include \
+    $(LOCAL_PATH)/../../../profiler/include
+
+LOCAL_CFLAGS := \
+    -DNDEBUG \
+    -O2 \
+    -std=c23 \
+    -D_GNU_SOURCE \
+    -Wall \
+    -Wextra \
+    -Wno-unused-parameter \
+    -Wno-unused-variable \
+    -Wno-sign-compare \
+    -Wno-missing-field-initializers
+
+LOCAL_LDLIBS += -llog
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,3 @@
+APP_ABI := armeabi-v7a arm64-v8a
+APP_OPTIM := release
+APP_PLATFORM := android-24
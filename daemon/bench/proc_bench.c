@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Time process lookups against the tree in NUSANTARA_PROC_ROOT, usually
+// one built by gen_proc_tree.sh:
+//   gen_proc_tree.sh /dev/shm/proc 2000
+//   NUSANTARA_PROC_ROOT=/dev/shm/proc proc_bench 400
+
+#include <nusantara.h>
+#include <time.h>
+
+char* gamestart = NULL;
+pid_t game_pid = 0;
+bool game_exit_pending = false;
+
+typedef pid_t (*LookupFunc)(const char* name);
+
+/***********************************************************************************
+ * Function Name      : bench
+ * Inputs             : label (const char *) - row label
+ *                      lookup (LookupFunc) - pidof or pidof_exact
+ *                      name (const char *) - process to look for
+ *                      iterations (int) - calls to time
+ * Returns            : None
+ * Description        : Prints the PID found and the mean time per call.
+ ***********************************************************************************/
+static void bench(const char* label, LookupFunc lookup, const char* name, int iterations) {
+    pid_t pid = lookup(name);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < iterations; i++)
+        lookup(name);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double elapsed_us = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+    printf("%-12s %-34s pid=%-6d %9.1f us/call\n", label, name, (int)pid, elapsed_us / iterations);
+}
+
+int main(int argc, char* argv[]) {
+    if (getenv("NUSANTARA_PROC_ROOT"))
+        proc_root = getenv("NUSANTARA_PROC_ROOT");
+
+    int iterations = argc > 1 ? atoi(argv[1]) : 200;
+    if (iterations <= 0) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("proc root: %s, %d iterations\n", proc_root, iterations);
+    bench("pidof", pidof, "com.mobile.legends", iterations);
+    bench("pidof", pidof, "com.not.running", iterations);
+    bench("pidof_exact", pidof_exact, "com.mobile.legends", iterations);
+    bench("pidof_exact", pidof_exact, "com.mobile.legends:UnityKillsMe", iterations);
+    bench("pidof_exact", pidof_exact, "com.not.running", iterations);
+    return EXIT_SUCCESS;
+}
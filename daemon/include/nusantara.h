@@ -12,26 +12,44 @@
 #include <time.h>
 #include <unistd.h>
 
+#include <proc_parse.h>
+
 #define LOOP_INTERVAL 15
+#define POLL_INTERVAL_MIN 1000
+#define POLL_INTERVAL_MAX 15000
+#define POLL_BURST_TICKS 5
 #define MAX_DATA_LENGTH 1024
 #define MAX_COMMAND_LENGTH 600
 #define MAX_OUTPUT_LENGTH 256
 #define MAX_PATH_LENGTH 256
 
+#define COMMAND_TIMEOUT_MS 10000
+#define PRELOAD_TIMEOUT_MS 60000
+#define TOAST_DURATION 2
+
 #define MAX_LINE 512
 #define MAX_PACKAGE 128
 
 #define NOTIFY_TITLE "Nusantara Tweaks"
 #define LOG_TAG "NusantaraTweaks"
 
+#define MODULE_CONFIG_DIR "/data/adb/.config/Nusantara"
 #define LOCK_FILE "/data/adb/.config/Nusantara/.lock"
 #define LOG_FILE "/data/adb/.config/Nusantara/nusantara.log"
 #define PROFILE_MODE "/data/adb/.config/Nusantara/current_profile"
 #define GAME_INFO "/data/adb/.config/Nusantara/gameinfo"
 #define GAMELIST "/data/adb/.config/Nusantara/gamelist.txt"
+#define POLL_MIN_CONFIG "/data/adb/.config/Nusantara/poll_interval_min"
+#define POLL_MAX_CONFIG "/data/adb/.config/Nusantara/poll_interval_max"
+#define SHELL_WORKER_CONFIG "/data/adb/.config/Nusantara/shell_worker"
+#define PACKAGE_CACHE "/data/adb/.config/Nusantara/package_cache"
 #define MODULE_PROP "/data/adb/modules/nusantara/module.prop"
 #define MODULE_UPDATE "/data/adb/modules/nusantara/update"
 
+#define DEFAULT_PROC_ROOT "/proc"
+#define DEFAULT_CPUSET_ROOT "/dev/cpuset"
+#define DEFAULT_FOCUS_SOURCE "/system/bin/logcat"
+
 #define MY_PATH                                                                                                                    \
     "PATH=/system/bin:/system/xbin:/data/adb/ap/bin:/data/adb/ksu/bin:/data/adb/magisk:/debug_ramdisk:/sbin:/sbin/su:/su/bin:/su/" \
     "xbin:/data/data/com.termux/files/usr/bin"
@@ -40,8 +58,6 @@
     (strcmp(gamestart, "com.mobile.legends") == 0 || strcmp(gamestart, "com.mobilelegends.hwag") == 0 || \
      strcmp(gamestart, "com.mobiin.gp") == 0 || strcmp(gamestart, "com.mobilechess.gp") == 0)
 
-#define IS_AWAKE(state) (strcmp(state, "Awake") == 0 || strcmp(state, "true") == 0)
-#define IS_LOW_POWER(state) (strcmp(state, "true") == 0 || strcmp(state, "1") == 0)
 
 // Basic C knowledge: enum starts with 0
 typedef enum : char {
@@ -65,15 +81,48 @@ typedef enum : char {
     MLBB_RUNNING
 } MLBBState;
 
+typedef struct {
+    char* output;
+    size_t length;
+    int status;
+    bool timed_out;
+} CommandResult;
+
+typedef struct {
+    int awake;
+    int low_power;
+    char* game;
+    bool power_sampled;
+    bool window_sampled;
+} DumpsysSnapshot;
+
+typedef struct {
+    char apk_dir[MAX_PATH_LENGTH];
+    char lib_dir[MAX_PATH_LENGTH];
+    char abi[16];
+    int uid;
+} PackageInfo;
+
+typedef bool (*EventHandler)(int fd);
+typedef bool (*LineHandler)(char* line, void* ctx);
+
 extern char* gamestart;
 extern char* custom_log_tag;
 extern pid_t game_pid;
+extern bool game_exit_pending;
+extern const char* proc_root;
+extern const char* cpuset_root;
+extern const char* focus_source;
 
 // Misc Utilities
 void sighandler(const int signal);
+int exit_signal_init(void);
+bool exit_signal_handle(int fd);
+int exit_signal_pending(void);
 char* trim_newline(char* string);
-void notify(const char* message);
-void toast(const char* message);
+void post_notification(const char* message);
+void show_toast(const char* message);
+void hide_toast(void);
 void is_kanged(void);
 char* timern(void);
 bool return_true(void);
@@ -83,10 +132,26 @@ bool return_false(void);
 extern void NusantaraPreload(const char* package);
 
 // Shell and Command execution
+pid_t spawn_command(const char* path, char* const argv[], int* read_fd);
+int run_command(const char* path, char* const argv[], int timeout_ms, CommandResult* result);
+int run_command_lines(const char* path, char* const argv[], int timeout_ms, LineHandler handler, void* ctx);
+int run_shell(const char* command, int timeout_ms, CommandResult* result);
+void free_command_result(CommandResult* result);
 char* execute_command(const char* format, ...);
 char* execute_direct(const char* path, const char* arg0, ...);
 int systemv(const char* format, ...);
 
+// Notification Dispatcher
+int notify_dispatcher_start(void);
+void notify_dispatcher_stop(void);
+void notify(const char* message);
+void toast(const char* message);
+
+// Shell Worker
+int shell_worker_start(void);
+void shell_worker_stop(void);
+bool shell_worker_run(const char* command, int timeout_ms, CommandResult* result, int* status);
+
 // File Utilities
 int create_lock_file(void);
 int write2file(const char* filename, const bool append, const bool use_flock, const char* data, ...);
@@ -98,7 +163,65 @@ void external_log(LogLevel level, const char* tag, const char* message);
 // Process Utilities
 void set_priority(const pid_t pid);
 pid_t pidof(const char* name);
+pid_t pidof_exact(const char* name);
+int package_uid(const char* name);
 int uidof(pid_t pid);
+int get_process_name(pid_t pid, char* name, size_t size);
+bool process_alive(pid_t pid);
+
+// Event Loop
+int event_loop_init(void);
+int event_loop_add(int fd, EventHandler handler);
+void event_loop_remove(int fd);
+bool wait_for_event(int timeout_ms);
+
+// Process Monitor
+int proc_monitor_init(void);
+bool proc_monitor_handle(int fd);
+
+// Exit Watcher
+int watch_process_exit(pid_t pid);
+void unwatch_process_exit(void);
+
+// Focus Monitor
+int focus_monitor_start(void);
+bool focus_monitor_handle(int fd);
+int focus_monitor_game(char** package);
+bool focus_monitor_screen_events(void);
+
+// Foreground Detection
+int get_foreground_game(char** package);
+
+// Screen State
+int read_screen_state(void);
+
+// Battery Saver Watcher
+int low_power_watch_init(void);
+bool low_power_watch_handle(int fd);
+int read_low_power_state(void);
+
+// Dumpsys Snapshot
+void dumpsys_snapshot_reset(void);
+int dumpsys_screen_state(void);
+int dumpsys_low_power_state(void);
+char* dumpsys_visible_game(void);
+
+// Adaptive Scheduler
+void scheduler_init(void);
+void scheduler_poke(void);
+void scheduler_set_screen(bool screen_on, bool screen_events);
+bool scheduler_suspended(void);
+int scheduler_next_interval(void);
+
+// Gamelist
+int gamelist_load(const char* path);
+bool gamelist_contains(const char* package);
+int gamelist_watch_init(void);
+bool gamelist_watch_handle(int fd);
+
+// Package Cache
+int package_cache_load(void);
+int package_cache_lookup(const char* package, PackageInfo* info);
 
 // MLBB Handler
 extern pid_t mlbb_pid;
@@ -108,8 +231,11 @@ MLBBState handle_mlbb(const char* gamestart);
 extern bool (*get_screenstate)(void);
 extern bool (*get_low_power_state)(void);
 char* get_gamestart(void);
+int profiler_config_watch_init(void);
+bool profiler_config_watch_handle(int fd);
 bool get_screenstate_normal(void);
 bool get_low_power_state_normal(void);
 void run_profiler(const int profile);
+void restore_profiler(void);
 
 #endif // NUSANTARA_H
@@ -0,0 +1,66 @@
+#ifndef PROC_PARSE_H
+#define PROC_PARSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+// Big enough for any single-page procfs or sysfs node
+#define PARSE_BUFFER_SIZE 4096
+
+typedef enum {
+    PARSE_OK = 0,
+    PARSE_ERR_IO = -1,       // node can't be opened or read
+    PARSE_ERR_FORMAT = -2,   // content doesn't look like expected
+    PARSE_ERR_RANGE = -3,    // number doesn't fit in destination
+    PARSE_ERR_MISSING = -4,  // requested field is not present
+    PARSE_ERR_TRUNCATED = -5 // more values than destination can hold
+} ParseStatus;
+
+typedef struct {
+    pid_t pid;
+    char comm[16];
+    char state;
+    pid_t ppid;
+    unsigned long long utime;
+    unsigned long long stime;
+    long num_threads;
+    unsigned long long starttime;
+} ProcStat;
+
+typedef struct {
+    long total_kb;
+    long free_kb;
+    long available_kb;
+    long cached_kb;
+    long swap_free_kb;
+} MemInfo;
+
+// Stall averages are kept as hundredths of a percent to stay in integers
+typedef struct {
+    int avg10;
+    int avg60;
+    int avg300;
+    unsigned long long total_us;
+} PressureStat;
+
+// Scanners
+int scan_long(const char** cursor, long* value);
+int scan_field(const char* text, const char* key, long* value);
+
+// Node readers
+ssize_t read_node_buffer(const char* path, char* buf, size_t size);
+int read_node_long(const char* path, long* value);
+int read_node_string(const char* path, char* buf, size_t size);
+int read_node_list(const char* path, long* values, size_t max, size_t* count);
+
+// Process nodes
+int parse_proc_stat(const char* path, ProcStat* stat);
+int parse_proc_status(const char* path, const char* key, long* value);
+int parse_proc_cmdline(const char* path, char* name, size_t size);
+
+// System wide nodes
+int parse_meminfo(MemInfo* info);
+int parse_pressure(const char* path, PressureStat* some, PressureStat* full);
+
+#endif // PROC_PARSE_H
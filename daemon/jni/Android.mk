@@ -11,9 +11,31 @@ LOCAL_SRC_FILES := \
     ../src/process_utils.c \
     ../src/misc_utils.c \
     ../src/preload_function.c \
-    ../src/mlbb_handler.c
+    ../src/mlbb_handler.c \
+    ../src/event_loop.c \
+    ../src/proc_monitor.c \
+    ../src/gamelist.c \
+    ../src/exit_watcher.c \
+    ../src/foreground.c \
+    ../src/screen_state.c \
+    ../src/low_power_watcher.c \
+    ../src/scheduler.c \
+    ../src/shell_worker.c \
+    ../src/dumpsys_snapshot.c \
+    ../src/notify_dispatcher.c \
+    ../src/focus_monitor.c \
+    ../src/proc_parse.c \
+    ../src/package_cache.c \
+    ../../profiler/src/nusantara_profiler.c \
+    ../../profiler/src/knob_writer.c \
+    ../../profiler/src/profile_table.c \
+    ../../profiler/src/topology.c \
+    ../../profiler/src/knob_baseline.c \
+    ../../profiler/src/opp_table.c
 
-LOCAL_C_INCLUDES := $(LOCAL_PATH)/../include
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/../include \
+    $(LOCAL_PATH)/../../profiler/include
 
 LOCAL_CFLAGS := \
     -DNDEBUG \
@@ -19,6 +19,7 @@
 
 char* gamestart = NULL;
 pid_t game_pid = 0;
+bool game_exit_pending = false;
 
 int is_file_empty(const char *filename) {
     FILE *file = fopen(filename, "rb");
@@ -85,6 +86,15 @@ int main(int argc, char* argv[]) {
         return EXIT_SUCCESS;
     }
 
+    // Allow pointing detectors to a fake /proc and cpuset tree,
+    // or to a scripted stand-in for the focus event stream
+    if (getenv("NUSANTARA_PROC_ROOT"))
+        proc_root = getenv("NUSANTARA_PROC_ROOT");
+    if (getenv("NUSANTARA_CPUSET_ROOT"))
+        cpuset_root = getenv("NUSANTARA_CPUSET_ROOT");
+    if (getenv("NUSANTARA_FOCUS_SOURCE"))
+        focus_source = getenv("NUSANTARA_FOCUS_SOURCE");
+
     // Sanity check for dumpsys
     if (access("/system/bin/dumpsys", F_OK) != 0) {
         fprintf(stderr, "\033[31mFATAL ERROR:\033[0m /system/bin/dumpsys: inaccessible or not found\n");
@@ -116,6 +126,12 @@ int main(int argc, char* argv[]) {
         exit(EXIT_FAILURE);
     }
 
+    if (gamelist_load(GAMELIST) <= 0) {
+        log_nusantara(LOG_WARN, "Gamelist is empty, event-driven detection will never fire");
+    }
+
+    package_cache_load();
+
     // Daemonize service
     if (daemon(0, 0)) {
         log_nusantara(LOG_FATAL, "Unable to daemonize service");
@@ -123,8 +139,17 @@ int main(int argc, char* argv[]) {
     }
 
     // Register signal handlers
-    signal(SIGINT, sighandler);
-    signal(SIGTERM, sighandler);
+    int exit_signal_fd = exit_signal_init();
+
+    // Deliver toasts and notifications without holding back profile switches
+    notify_dispatcher_start();
+
+    // Keep one shell around instead of starting a new one for every command
+    FILE* worker_config = fopen(SHELL_WORKER_CONFIG, "r");
+    if (!worker_config || fgetc(worker_config) != '0')
+        shell_worker_start();
+    if (worker_config)
+        fclose(worker_config);
 
     // Initialize variables
     bool need_profile_checkup = false;
@@ -134,23 +159,59 @@ int main(int argc, char* argv[]) {
     log_nusantara(LOG_INFO, "Daemon started as PID %d", getpid());
     run_profiler(PERFCOMMON); // exec perfcommon
 
+    // Wake up immediately on game launch, focus change, battery saver toggle or gamelist edit instead
+    // of waiting for next tick, polling still works as fallback.
+    if (event_loop_init() == 0) {
+        event_loop_add(exit_signal_fd, exit_signal_handle);
+        event_loop_add(proc_monitor_init(), proc_monitor_handle);
+        event_loop_add(low_power_watch_init(), low_power_watch_handle);
+        event_loop_add(gamelist_watch_init(), gamelist_watch_handle);
+        event_loop_add(profiler_config_watch_init(), profiler_config_watch_handle);
+        focus_monitor_start();
+    }
+
+    scheduler_init();
+
     while (1) {
-        sleep(LOOP_INTERVAL);
+        // Game process may spawn before its window is visible,
+        // poll quickly for a while after being woken up.
+        if (wait_for_event(scheduler_next_interval()))
+            scheduler_poke();
+
+        // Exit gracefully, leaving knobs as the system had them
+        int exit_signal = exit_signal_pending();
+        if (exit_signal) [[clang::unlikely]] {
+            log_nusantara(LOG_INFO, "Received %s, exiting.", exit_signal == SIGTERM ? "SIGTERM" : "SIGINT");
+            restore_profiler();
+            break;
+        }
+
+        // dumpsys fallbacks sample each source at most once per tick
+        dumpsys_snapshot_reset();
 
         // Handle case when module gets updated
         if (access(MODULE_UPDATE, F_OK) == 0) [[clang::unlikely]] {
             log_nusantara(LOG_INFO, "Module update detected, exiting.");
             notify("Please reboot your device to complete module update.");
+            restore_profiler();
             break;
         }
 
+        // Suspend detection while screen is off, waking up on screen
+        // events alone when the focus stream reports them
+        bool screen_on = get_screenstate();
+        scheduler_set_screen(screen_on, focus_monitor_screen_events());
+
         // Only fetch gamestart when user not in-game
         // prevent overhead from dumpsys commands.
         if (!gamestart) {
-            gamestart = get_gamestart();
-        } else if (game_pid != 0 && kill(game_pid, 0) == -1) [[clang::unlikely]] {
+            if (screen_on)
+                gamestart = get_gamestart();
+        } else if (game_pid != 0 && (game_exit_pending || !process_alive(game_pid))) [[clang::unlikely]] {
             log_nusantara(LOG_INFO, "Game %s exited, resetting profile...", gamestart);
             game_pid = 0;
+            game_exit_pending = false;
+            unwatch_process_exit();
             free(gamestart);
             gamestart = get_gamestart();
 
@@ -161,7 +222,7 @@ int main(int argc, char* argv[]) {
         if (gamestart)
             mlbb_is_running = handle_mlbb(gamestart);
 
-        if (gamestart && get_screenstate() && mlbb_is_running != MLBB_RUN_BG) {
+        if (gamestart && screen_on && mlbb_is_running != MLBB_RUN_BG) {
             // Bail out if we already on performance profile
             // However we will pass this if need_profile_checkup was true
             if (!need_profile_checkup && cur_mode == PERFORMANCE_PROFILE)
@@ -169,7 +230,7 @@ int main(int argc, char* argv[]) {
 
             // Get PID and check if the game is "real" running program
             // Handle weird behavior of MLBB
-            game_pid = (mlbb_is_running == MLBB_RUNNING) ? mlbb_pid : pidof(gamestart);
+            game_pid = (mlbb_is_running == MLBB_RUNNING) ? mlbb_pid : pidof_exact(gamestart);
             if (game_pid == 0) [[clang::unlikely]] {
                 log_nusantara(LOG_ERROR, "Unable to fetch PID of %s", gamestart);
                 free(gamestart);
@@ -177,8 +238,14 @@ int main(int argc, char* argv[]) {
                 continue;
             }
 
+            // Revert profile as soon as game exits, kill() polling
+            // above remains as fallback when pidfd is unavailable.
+            game_exit_pending = false;
+            watch_process_exit(game_pid);
+
             cur_mode = PERFORMANCE_PROFILE;
             need_profile_checkup = false;
+            scheduler_poke();
             toast("Applying performance profile");
             run_profiler(PERFORMANCE_PROFILE);
             set_priority(game_pid);
@@ -191,6 +258,7 @@ int main(int argc, char* argv[]) {
 
             cur_mode = POWERSAVE_PROFILE;
             need_profile_checkup = false;
+            scheduler_poke();
             toast("Applying powersave profile");
             run_profiler(POWERSAVE_PROFILE);
             log_nusantara(LOG_INFO, "Applying powersave profile");
@@ -201,6 +269,7 @@ int main(int argc, char* argv[]) {
 
             cur_mode = NORMAL_PROFILE;
             need_profile_checkup = false;
+            scheduler_poke();
             toast("Applying normal profile");
             run_profiler(NORMAL_PROFILE);
             log_nusantara(LOG_INFO, "Applying normal profile");
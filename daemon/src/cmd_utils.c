@@ -15,67 +15,359 @@
  */
 
 #include <nusantara.h>
+#include <errno.h>
+#include <poll.h>
+
+#define OUTPUT_CHUNK 512
+#define REAP_POLL_MAX_MS 50
 
 /***********************************************************************************
- * Function Name      : execute_command
- * Inputs             : command (const char *) - shell command to execute
- * Returns            : char * - Pointer to the dynamically allocated output of the command
- *                      variadic arguments - Additional arguments for command
- * Description        : Executes a shell command and captures its output.
+ * Function Name      : elapsed_ms
+ * Inputs             : start (const struct timespec *) - start time
+ * Returns            : long long - milliseconds elapsed since start
+ * Description        : Monotonic time helper for command deadlines.
  ***********************************************************************************/
-char* execute_command(const char* format, ...) {
-    char command[MAX_COMMAND_LENGTH];
-    va_list args;
-    va_start(args, format);
-    vsnprintf(command, sizeof(command), format, args);
-    va_end(args);
+static long long elapsed_ms(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1000LL + (now.tv_nsec - start->tv_nsec) / 1000000;
+}
 
+/***********************************************************************************
+ * Function Name      : spawn_command
+ * Inputs             : path (const char *) - absolute path to the executable
+ *                      argv (char * const []) - NULL terminated argument list
+ *                      read_fd (int *) - receives read end of child's stdout
+ * Returns            : pid_t - PID of child, -1 on error
+ * Description        : Spawns a command with vfork() in its own process group.
+ ***********************************************************************************/
+pid_t spawn_command(const char* path, char* const argv[], int* read_fd) {
     int pipefd[2];
-    if (pipe(pipefd) == -1) [[clang::unlikely]] {
-        log_nusantara(LOG_ERROR, "pipe failed in execute_command()");
-        return NULL;
+    if (pipe2(pipefd, O_CLOEXEC) == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_ERROR, "pipe failed in run_command()");
+        return -1;
     }
 
-    pid_t pid = fork();
+    char* env[] = {MY_PATH, NULL};
+    pid_t pid = vfork();
     if (pid == -1) [[clang::unlikely]] {
         close(pipefd[0]);
         close(pipefd[1]);
-        log_nusantara(LOG_ERROR, "fork failed in execute_command()");
-        return NULL;
+        log_nusantara(LOG_ERROR, "vfork failed in run_command()");
+        return -1;
     }
 
     if (pid == 0) {
+        // Own process group, so timeout also kills the whole pipeline
+        setpgid(0, 0);
         dup2(pipefd[1], STDOUT_FILENO);
-        close(pipefd[0]);
-        close(pipefd[1]);
-
-        char* env[] = {MY_PATH, NULL};
-        execle("/system/bin/sh", "sh", "-c", command, NULL, env);
+        execve(path, argv, env);
         _exit(127);
     }
 
     close(pipefd[1]);
+    *read_fd = pipefd[0];
+    return pid;
+}
+
+/***********************************************************************************
+ * Function Name      : reap_command
+ * Inputs             : pid (pid_t) - PID of child
+ *                      killed (bool) - whether child got killed by us
+ *                      start (const struct timespec *) - command start time
+ *                      timeout_ms (int) - deadline for the whole command
+ *                      timed_out (bool *) - set to true if deadline passed while
+ *                                           waiting for exit
+ * Returns            : int - exit status of the command, -1 if killed
+ * Description        : Wait for spawned command and collect its exit status. A
+ *                      command may close its stdout and keep running, so the
+ *                      deadline still applies after EOF.
+ ***********************************************************************************/
+static int reap_command(pid_t pid, bool killed, const struct timespec* start, int timeout_ms, bool* timed_out) {
+    int status;
+    int delay_ms = 1;
+    while (!killed) {
+        pid_t reaped = waitpid(pid, &status, WNOHANG);
+        if (reaped == pid)
+            return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+        if (reaped == -1 && errno != EINTR) [[clang::unlikely]]
+            return -1;
+
+        long long remaining = timeout_ms - elapsed_ms(start);
+        if (remaining <= 0) {
+            kill(-pid, SIGKILL);
+            *timed_out = true;
+            killed = true;
+            break;
+        }
 
-    char output[MAX_OUTPUT_LENGTH] = {0};
-    ssize_t total_read = 0;
+        usleep((remaining < delay_ms ? remaining : delay_ms) * 1000);
+        delay_ms = (delay_ms * 2 > REAP_POLL_MAX_MS) ? REAP_POLL_MAX_MS : delay_ms * 2;
+    }
+
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR)
+        ;
+
+    return -1;
+}
+
+/***********************************************************************************
+ * Function Name      : wait_readable
+ * Inputs             : fd (int) - fd to wait for
+ *                      start (const struct timespec *) - command start time
+ *                      timeout_ms (int) - deadline for the whole command
+ * Returns            : int - 1 if readable, 0 on timeout, -1 on error
+ * Description        : Poll command output against its deadline.
+ ***********************************************************************************/
+static int wait_readable(int fd, const struct timespec* start, int timeout_ms) {
     while (1) {
-        ssize_t bytes = read(pipefd[0], output + total_read, sizeof(output) - total_read - 1);
+        int remaining = timeout_ms - (int)elapsed_ms(start);
+        if (remaining <= 0)
+            return 0;
+
+        struct pollfd pfd = {.fd = fd, .events = POLLIN};
+        int ready = poll(&pfd, 1, remaining);
+        if (ready == -1 && errno == EINTR)
+            continue;
+
+        return ready;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : run_command
+ * Inputs             : path (const char *) - absolute path to the executable
+ *                      argv (char * const []) - NULL terminated argument list
+ *                      timeout_ms (int) - deadline for the whole command
+ *                      result (CommandResult *) - receives output and exit status,
+ *                                                 may be NULL to discard output
+ * Returns            : int - exit status of the command
+ *                           -1 if it failed to start, got killed or timed out
+ * Description        : Spawns a command with vfork(), reads its stdout into a growable
+ *                      buffer and kills its whole process group once deadline passes.
+ * Note               : Caller is responsible for free_command_result().
+ ***********************************************************************************/
+int run_command(const char* path, char* const argv[], int timeout_ms, CommandResult* result) {
+    if (result)
+        *result = (CommandResult){.output = NULL, .length = 0, .status = -1, .timed_out = false};
+
+    int fd;
+    pid_t pid = spawn_command(path, argv, &fd);
+    if (pid == -1) [[clang::unlikely]]
+        return -1;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    size_t capacity = OUTPUT_CHUNK;
+    size_t length = 0;
+    char* output = result ? malloc(capacity) : NULL;
+    bool timed_out = false;
+
+    while (1) {
+        int ready = wait_readable(fd, &start, timeout_ms);
+        if (ready == 0) {
+            timed_out = true;
+            break;
+        }
+
+        if (ready == -1) [[clang::unlikely]]
+            break;
+
+        // Keep room for null terminator
+        if (output && length + 1 >= capacity) {
+            char* grown = realloc(output, capacity * 2);
+            if (!grown) [[clang::unlikely]]
+                break;
+            output = grown;
+            capacity *= 2;
+        }
+
+        char discard[OUTPUT_CHUNK];
+        ssize_t bytes = output ? read(fd, output + length, capacity - length - 1) : read(fd, discard, sizeof(discard));
+        if (bytes == -1 && errno == EINTR)
+            continue;
+
         if (bytes <= 0)
             break;
 
-        total_read += bytes;
+        if (output)
+            length += bytes;
+    }
+    close(fd);
+
+    if (timed_out) [[clang::unlikely]]
+        kill(-pid, SIGKILL);
+
+    int exit_status = reap_command(pid, timed_out, &start, timeout_ms, &timed_out);
+    if (timed_out) [[clang::unlikely]]
+        log_nusantara(LOG_WARN, "%s timed out after %dms, killed", argv[0], timeout_ms);
+
+    if (output)
+        output[length] = '\0';
+
+    if (result) {
+        result->output = output;
+        result->length = length;
+        result->status = exit_status;
+        result->timed_out = timed_out;
+    } else {
+        free(output);
+    }
+
+    return exit_status;
+}
+
+/***********************************************************************************
+ * Function Name      : run_command_lines
+ * Inputs             : path (const char *) - absolute path to the executable
+ *                      argv (char * const []) - NULL terminated argument list
+ *                      timeout_ms (int) - deadline for the whole command
+ *                      handler (LineHandler) - called for every output line
+ *                      ctx (void *) - passed through to handler
+ * Returns            : int - exit status of the command, 0 if handler stopped early
+ *                           -1 if it failed to start, got killed or timed out
+ * Description        : Spawns a command and streams its stdout line by line into
+ *                      handler without buffering whole output. Once handler returns
+ *                      false, the command is killed as the rest isn't needed.
+ * Note               : Lines longer than MAX_DATA_LENGTH are split.
+ ***********************************************************************************/
+int run_command_lines(const char* path, char* const argv[], int timeout_ms, LineHandler handler, void* ctx) {
+    int fd;
+    pid_t pid = spawn_command(path, argv, &fd);
+    if (pid == -1) [[clang::unlikely]]
+        return -1;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    char line[MAX_DATA_LENGTH];
+    size_t length = 0;
+    bool timed_out = false;
+    bool stopped = false;
+
+    while (!stopped) {
+        int ready = wait_readable(fd, &start, timeout_ms);
+        if (ready == 0) {
+            timed_out = true;
+            break;
+        }
+
+        if (ready == -1) [[clang::unlikely]]
+            break;
+
+        ssize_t bytes = read(fd, line + length, sizeof(line) - 1 - length);
+        if (bytes == -1 && errno == EINTR)
+            continue;
 
-        if (total_read >= (ssize_t)(sizeof(output) - 1))
+        if (bytes <= 0)
             break;
+
+        length += bytes;
+
+        // Hand over every complete line, keep the partial tail for next read
+        char* cursor = line;
+        char* newline;
+        while (!stopped && (newline = memchr(cursor, '\n', line + length - cursor))) {
+            *newline = '\0';
+            stopped = !handler(cursor, ctx);
+            cursor = newline + 1;
+        }
+
+        length -= cursor - line;
+        if (length == sizeof(line) - 1) {
+            line[length] = '\0';
+            stopped = !handler(line, ctx);
+            length = 0;
+        } else {
+            memmove(line, cursor, length);
+        }
     }
-    close(pipefd[0]);
 
+    if (!stopped && !timed_out && length > 0) {
+        line[length] = '\0';
+        handler(line, ctx);
+    }
+    close(fd);
+
+    if (timed_out || stopped)
+        kill(-pid, SIGKILL);
+
+    int exit_status = reap_command(pid, timed_out || stopped, &start, timeout_ms, &timed_out);
+    if (timed_out) [[clang::unlikely]]
+        log_nusantara(LOG_WARN, "%s timed out after %dms, killed", argv[0], timeout_ms);
+
+    return stopped ? 0 : exit_status;
+}
+
+/***********************************************************************************
+ * Function Name      : free_command_result
+ * Inputs             : result (CommandResult *) - result filled by run_command()
+ * Returns            : None
+ * Description        : Release captured command output.
+ ***********************************************************************************/
+void free_command_result(CommandResult* result) {
+    free(result->output);
+    result->output = NULL;
+    result->length = 0;
+}
+
+/***********************************************************************************
+ * Function Name      : run_shell
+ * Inputs             : command (const char *) - shell command line
+ *                      timeout_ms (int) - deadline for the whole command
+ *                      result (CommandResult *) - receives output, may be NULL
+ * Returns            : int - exit status, -1 on failure or timeout
+ * Description        : Runs a command line through the shell worker when it is
+ *                      available, otherwise through /system/bin/sh -c.
+ ***********************************************************************************/
+int run_shell(const char* command, int timeout_ms, CommandResult* result) {
     int status;
-    waitpid(pid, &status, 0);
-    if (WEXITSTATUS(status))
+    if (shell_worker_run(command, timeout_ms, result, &status))
+        return status;
+
+    char* argv[] = {"sh", "-c", (char*)command, NULL};
+    return run_command("/system/bin/sh", argv, timeout_ms, result);
+}
+
+/***********************************************************************************
+ * Function Name      : first_line
+ * Inputs             : result (CommandResult *) - result filled by run_command()
+ *                      status (int) - exit status returned by run_command()
+ * Returns            : char * - dynamically allocated first line of output,
+ *                      NULL if command failed
+ * Description        : Adapter for callers that only want a single line answer.
+ ***********************************************************************************/
+static char* first_line(CommandResult* result, int status) {
+    if (status != 0 || !result->output) {
+        free_command_result(result);
         return NULL;
+    }
 
-    return strdup(trim_newline(output));
+    // Hand over the buffer itself, no need to copy it
+    char* output = trim_newline(result->output);
+    result->output = NULL;
+    return output;
+}
+
+/***********************************************************************************
+ * Function Name      : execute_command
+ * Inputs             : command (const char *) - shell command to execute
+ * Returns            : char * - Pointer to the dynamically allocated output of the command
+ *                      variadic arguments - Additional arguments for command
+ * Description        : Executes a shell command and captures first line of its output.
+ ***********************************************************************************/
+char* execute_command(const char* format, ...) {
+    char command[MAX_COMMAND_LENGTH];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(command, sizeof(command), format, args);
+    va_end(args);
+
+    CommandResult result;
+    int status = run_shell(command, COMMAND_TIMEOUT_MS, &result);
+    return first_line(&result, status);
 }
 
 /***********************************************************************************
@@ -84,7 +376,8 @@ char* execute_command(const char* format, ...) {
  *                      arg0 (const char *) - First argument (typically the program name)
  *                      variadic arguments - Additional arguments, must end with NULL
  * Returns            : char * - Pointer to the dynamically allocated output of the command
- * Description        : Executes a binary directly with specified arguments and captures output.
+ * Description        : Executes a binary directly with specified arguments and captures
+ *                      first line of its output.
  * Note               : Caller is responsible for freeing the returned string.
  ***********************************************************************************/
 char* execute_direct(const char* path, const char* arg0, ...) {
@@ -102,51 +395,9 @@ char* execute_direct(const char* path, const char* arg0, ...) {
     argv[argc] = NULL;
     va_end(args);
 
-    int pipefd[2];
-    if (pipe(pipefd) == -1) [[clang::unlikely]] {
-        log_nusantara(LOG_ERROR, "pipe failed in execute_direct()");
-        return NULL;
-    }
-
-    pid_t pid = fork();
-    if (pid == -1) [[clang::unlikely]] {
-        close(pipefd[0]);
-        close(pipefd[1]);
-        log_nusantara(LOG_ERROR, "fork failed in execute_direct()");
-        return NULL;
-    }
-
-    if (pid == 0) {
-        dup2(pipefd[1], STDOUT_FILENO);
-        close(pipefd[0]);
-        close(pipefd[1]);
-
-        execv(path, (char* const*)argv);
-        _exit(127);
-    }
-
-    close(pipefd[1]);
-
-    char output[MAX_OUTPUT_LENGTH] = {0};
-    ssize_t total_read = 0;
-    while (1) {
-        ssize_t bytes = read(pipefd[0], output + total_read, sizeof(output) - total_read - 1);
-        if (bytes <= 0)
-            break;
-
-        total_read += bytes;
-
-        if (total_read >= (ssize_t)(sizeof(output) - 1))
-            break;
-    }
-    close(pipefd[0]);
-
-    int status;
-    waitpid(pid, &status, 0);
-    if (WEXITSTATUS(status))
-        return NULL;
-
-    return strdup(trim_newline(output));
+    CommandResult result;
+    int status = run_command(path, (char* const*)argv, COMMAND_TIMEOUT_MS, &result);
+    return first_line(&result, status);
 }
 
 /***********************************************************************************
@@ -155,6 +406,7 @@ char* execute_direct(const char* path, const char* arg0, ...) {
  *                      variadic arguments - other arguments
  * Returns            : int - non zero are error, following system() returns.
  * Description        : Executes a shell command just like system() with additional format.
+ *                      Output is discarded and command is killed after COMMAND_TIMEOUT_MS.
  ***********************************************************************************/
 int systemv(const char* format, ...) {
     char command[MAX_COMMAND_LENGTH];
@@ -162,5 +414,5 @@ int systemv(const char* format, ...) {
     va_start(args, format);
     vsnprintf(command, sizeof(command), format, args);
     va_end(args);
-    return system(command);
+    return run_shell(command, COMMAND_TIMEOUT_MS, NULL);
 }
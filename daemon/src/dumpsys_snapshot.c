@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+#define WAKEFULNESS_KEY "mWakefulness="
+#define BATTERY_SAVER_KEY "mSettingBatterySaverEnabled="
+#define PACKAGE_KEY "package="
+
+static DumpsysSnapshot snapshot = {.awake = -1, .low_power = -1, .game = NULL};
+
+/***********************************************************************************
+ * Function Name      : parse_power_line
+ * Inputs             : line (char *) - line of dumpsys power output
+ *                      ctx (void *) - DumpsysSnapshot being filled
+ * Returns            : bool - false once both fields are known
+ * Description        : Pick mWakefulness and mSettingBatterySaverEnabled out of
+ *                      dumpsys power, which prints them before its long history.
+ ***********************************************************************************/
+static bool parse_power_line(char* line, void* ctx) {
+    DumpsysSnapshot* snap = ctx;
+
+    while (*line == ' ')
+        line++;
+
+    if (strncmp(line, WAKEFULNESS_KEY, sizeof(WAKEFULNESS_KEY) - 1) == 0) {
+        // Dreaming and Dozing count as asleep
+        snap->awake = strncmp(line + sizeof(WAKEFULNESS_KEY) - 1, "Awake", 5) == 0;
+    } else if (strncmp(line, BATTERY_SAVER_KEY, sizeof(BATTERY_SAVER_KEY) - 1) == 0) {
+        snap->low_power = strncmp(line + sizeof(BATTERY_SAVER_KEY) - 1, "true", 4) == 0;
+    }
+
+    return snap->awake == -1 || snap->low_power == -1;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_window_line
+ * Inputs             : line (char *) - line of dumpsys window output
+ *                      ctx (void *) - DumpsysSnapshot being filled
+ * Returns            : bool - false once a listed game is found
+ * Description        : Look up package= fields of visible windows in gamelist.
+ ***********************************************************************************/
+static bool parse_window_line(char* line, void* ctx) {
+    DumpsysSnapshot* snap = ctx;
+
+    for (char* field = line; (field = strstr(field, PACKAGE_KEY));) {
+        field += sizeof(PACKAGE_KEY) - 1;
+        size_t len = strcspn(field, " \t\r");
+        if (len > 0 && len < MAX_PACKAGE) {
+            char package[MAX_PACKAGE];
+            memcpy(package, field, len);
+            package[len] = '\0';
+            if (gamelist_contains(package)) {
+                snap->game = strdup(package);
+                return false;
+            }
+        }
+        field += len;
+    }
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : dumpsys_snapshot_reset
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Invalidate values sampled in previous tick. Each source is
+ *                      sampled again, once, the first time it's needed.
+ ***********************************************************************************/
+void dumpsys_snapshot_reset(void) {
+    free(snapshot.game);
+    snapshot = (DumpsysSnapshot){.awake = -1, .low_power = -1, .game = NULL};
+}
+
+/***********************************************************************************
+ * Function Name      : sample_power
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Run dumpsys power once per tick, filling both screen and
+ *                      battery saver state.
+ ***********************************************************************************/
+static void sample_power(void) {
+    if (snapshot.power_sampled)
+        return;
+
+    char* argv[] = {"dumpsys", "power", NULL};
+    snapshot.power_sampled = true;
+    if (run_command_lines("/system/bin/dumpsys", argv, COMMAND_TIMEOUT_MS, parse_power_line, &snapshot) == -1)
+        log_nusantara(LOG_WARN, "dumpsys power failed");
+}
+
+/***********************************************************************************
+ * Function Name      : dumpsys_screen_state
+ * Inputs             : None
+ * Returns            : int - 1 if awake, 0 if asleep, -1 on error
+ * Description        : Last resort screen state source through dumpsys power.
+ ***********************************************************************************/
+int dumpsys_screen_state(void) {
+    sample_power();
+    return snapshot.awake;
+}
+
+/***********************************************************************************
+ * Function Name      : dumpsys_low_power_state
+ * Inputs             : None
+ * Returns            : int - 1 if battery saver enabled, 0 if disabled, -1 on error
+ * Description        : Battery saver state through dumpsys power.
+ ***********************************************************************************/
+int dumpsys_low_power_state(void) {
+    sample_power();
+    return snapshot.low_power;
+}
+
+/***********************************************************************************
+ * Function Name      : dumpsys_visible_game
+ * Inputs             : None
+ * Returns            : char * - dynamically allocated package name of a visible game,
+ *                      NULL if none
+ * Description        : Run dumpsys window visible-apps once per tick and match its
+ *                      windows against gamelist.
+ * Note               : Caller is responsible for freeing the returned string.
+ ***********************************************************************************/
+char* dumpsys_visible_game(void) {
+    if (!snapshot.window_sampled) {
+        char* argv[] = {"dumpsys", "window", "visible-apps", NULL};
+        snapshot.window_sampled = true;
+        if (run_command_lines("/system/bin/dumpsys", argv, COMMAND_TIMEOUT_MS, parse_window_line, &snapshot) == -1)
+            log_nusantara(LOG_WARN, "dumpsys window failed");
+    }
+
+    return snapshot.game ? strdup(snapshot.game) : NULL;
+}
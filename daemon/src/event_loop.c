@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <sys/epoll.h>
+
+#define MAX_EVENT_SOURCES 8
+
+typedef struct {
+    int fd;
+    EventHandler handler;
+} EventSource;
+
+static int epoll_fd = -1;
+static EventSource sources[MAX_EVENT_SOURCES] = {[0 ... MAX_EVENT_SOURCES - 1] = {.fd = -1}};
+
+/***********************************************************************************
+ * Function Name      : monotonic_ms
+ * Inputs             : None
+ * Returns            : long long - monotonic clock in milliseconds
+ * Description        : Reads CLOCK_MONOTONIC, same clock used by epoll_wait timeout.
+ ***********************************************************************************/
+static long long monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : event_loop_init
+ * Inputs             : None
+ * Returns            : int - 0 on success
+ *                           -1 if epoll is unavailable
+ * Description        : Creates epoll instance used by main loop to wait for events.
+ * Note               : When this fails, wait_for_event() falls back to plain sleep.
+ ***********************************************************************************/
+int event_loop_init(void) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "epoll unavailable, falling back to polling");
+        return -1;
+    }
+
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : event_loop_add
+ * Inputs             : fd (int) - file descriptor to watch for readability
+ *                      handler (EventHandler) - called when fd becomes readable
+ * Returns            : int - 0 on success
+ *                           -1 on error
+ * Description        : Registers an event source into main loop.
+ ***********************************************************************************/
+int event_loop_add(int fd, EventHandler handler) {
+    if (epoll_fd == -1 || fd < 0)
+        return -1;
+
+    for (int i = 0; i < MAX_EVENT_SOURCES; i++) {
+        if (sources[i].fd != -1)
+            continue;
+
+        struct epoll_event ev = {.events = EPOLLIN, .data.ptr = &sources[i]};
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) [[clang::unlikely]] {
+            log_nusantara(LOG_ERROR, "Unable to watch fd %d: %s", fd, strerror(errno));
+            return -1;
+        }
+
+        sources[i].fd = fd;
+        sources[i].handler = handler;
+        return 0;
+    }
+
+    log_nusantara(LOG_ERROR, "Too many event sources, fd %d not watched", fd);
+    return -1;
+}
+
+/***********************************************************************************
+ * Function Name      : event_loop_remove
+ * Inputs             : fd (int) - file descriptor to stop watching
+ * Returns            : None
+ * Description        : Unregisters an event source. Caller still owns the fd.
+ ***********************************************************************************/
+void event_loop_remove(int fd) {
+    for (int i = 0; i < MAX_EVENT_SOURCES; i++) {
+        if (sources[i].fd != fd)
+            continue;
+
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        sources[i].fd = -1;
+        sources[i].handler = NULL;
+        return;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : wait_for_event
+ * Inputs             : timeout_ms (int) - maximum time to wait, -1 for no limit
+ * Returns            : bool - true if an event source requested early wakeup
+ *                             false if timeout elapsed
+ * Description        : Blocks until timeout elapsed or one of registered handlers
+ *                      reports an event that needs main loop attention.
+ *                      Handlers that consume irrelevant events keep us waiting for
+ *                      the remaining time, so they never add extra loop iterations.
+ ***********************************************************************************/
+bool wait_for_event(int timeout_ms) {
+    if (epoll_fd == -1) [[clang::unlikely]] {
+        usleep((timeout_ms < 0 ? LOOP_INTERVAL * 1000 : timeout_ms) * 1000);
+        return false;
+    }
+
+    const long long deadline = monotonic_ms() + timeout_ms;
+    int remaining = timeout_ms;
+
+    while (remaining > 0 || timeout_ms < 0) {
+        struct epoll_event events[MAX_EVENT_SOURCES];
+        int ready = epoll_wait(epoll_fd, events, MAX_EVENT_SOURCES, remaining);
+
+        if (ready == -1 && errno != EINTR) [[clang::unlikely]] {
+            log_nusantara(LOG_ERROR, "epoll_wait failed: %s", strerror(errno));
+            usleep((remaining < 0 ? LOOP_INTERVAL * 1000 : remaining) * 1000);
+            return false;
+        }
+
+        bool wake = false;
+        for (int i = 0; i < ready; i++) {
+            EventSource* source = events[i].data.ptr;
+            if (source->fd != -1 && source->handler(source->fd))
+                wake = true;
+        }
+
+        if (wake)
+            return true;
+
+        if (timeout_ms >= 0)
+            remaining = (int)(deadline - monotonic_ms());
+    }
+
+    return false;
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+
+// Unified syscall number across all supported ABIs, missing from older headers
+#ifndef __NR_pidfd_open
+    #define __NR_pidfd_open 434
+#endif
+
+#define MAX_WATCHED_PIDS 2
+
+typedef struct {
+    pid_t pid;
+    int fd;
+} WatchedProcess;
+
+static WatchedProcess watched[MAX_WATCHED_PIDS] = {[0 ... MAX_WATCHED_PIDS - 1] = {.pid = 0, .fd = -1}};
+static bool pidfd_supported = true;
+
+/***********************************************************************************
+ * Function Name      : release_slot
+ * Inputs             : slot (WatchedProcess *) - watched process entry
+ * Returns            : None
+ * Description        : Stop watching a process and close its pidfd.
+ ***********************************************************************************/
+static void release_slot(WatchedProcess* slot) {
+    if (slot->fd != -1) {
+        event_loop_remove(slot->fd);
+        close(slot->fd);
+    }
+
+    slot->pid = 0;
+    slot->fd = -1;
+}
+
+/***********************************************************************************
+ * Function Name      : process_exit_handle
+ * Inputs             : fd (int) - pidfd that became readable
+ * Returns            : bool - true if main loop should re-evaluate now
+ * Description        : pidfd becomes readable once the process exited, mark the
+ *                      game as gone so main loop reverts profile right away.
+ * Note               : kill(pid, 0) still succeeds on zombie, which is why we
+ *                      can't rely on it here.
+ ***********************************************************************************/
+static bool process_exit_handle(int fd) {
+    for (int i = 0; i < MAX_WATCHED_PIDS; i++) {
+        if (watched[i].fd != fd)
+            continue;
+
+        pid_t pid = watched[i].pid;
+        release_slot(&watched[i]);
+        log_nusantara(LOG_DEBUG, "Watched process %d exited", pid);
+
+        if (pid == mlbb_pid)
+            mlbb_pid = 0;
+
+        if (pid == game_pid) {
+            game_exit_pending = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : watch_process_exit
+ * Inputs             : pid (pid_t) - PID to watch
+ * Returns            : int - 0 if process is being watched
+ *                           -1 if pidfd is unavailable, caller should poll instead
+ * Description        : Hold a pidfd for given process and get notified through
+ *                      main event loop as soon as it exits.
+ * Note               : pidfd_open() requires Linux 5.3+.
+ ***********************************************************************************/
+int watch_process_exit(pid_t pid) {
+    if (!pidfd_supported || pid <= 0)
+        return -1;
+
+    int free_slot = -1;
+    for (int i = 0; i < MAX_WATCHED_PIDS; i++) {
+        if (watched[i].pid == pid)
+            return 0;
+
+        if (free_slot == -1 && watched[i].fd == -1)
+            free_slot = i;
+    }
+
+    if (free_slot == -1) [[clang::unlikely]]
+        return -1;
+
+    int fd = (int)syscall(__NR_pidfd_open, pid, 0);
+    if (fd == -1) {
+        if (errno == ENOSYS) {
+            pidfd_supported = false;
+            log_nusantara(LOG_INFO, "pidfd unsupported by kernel, polling game exit");
+        }
+        return -1;
+    }
+
+    if (event_loop_add(fd, process_exit_handle) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    watched[free_slot].pid = pid;
+    watched[free_slot].fd = fd;
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : unwatch_process_exit
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Drop all held pidfds.
+ ***********************************************************************************/
+void unwatch_process_exit(void) {
+    for (int i = 0; i < MAX_WATCHED_PIDS; i++)
+        release_slot(&watched[i]);
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+
+#define RESTART_BACKOFF_MIN 1000
+#define RESTART_BACKOFF_MAX 60000
+
+const char* focus_source = DEFAULT_FOCUS_SOURCE;
+
+static pid_t source_pid = -1;
+static int source_fd = -1;
+static int backoff = RESTART_BACKOFF_MIN;
+static long long restart_at = 0;
+static long long started_at = 0;
+
+// Partial line carried over between reads
+static char pending[MAX_DATA_LENGTH];
+static size_t pending_len = 0;
+
+// Focus is unknown until stream reports its first event
+static bool focus_known = false;
+static char focused_game[MAX_PACKAGE];
+
+// Set once stream reports a screen change, not every ROM logs them
+static bool screen_events_seen = false;
+
+/***********************************************************************************
+ * Function Name      : now_ms
+ * Inputs             : None
+ * Returns            : long long - monotonic clock in milliseconds
+ * Description        : Clock used for restart backoff.
+ ***********************************************************************************/
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : match_component
+ * Inputs             : component (const char *) - component or activity class name
+ *                      len (size_t) - length of component
+ *                      package (char *) - receives matched game package
+ * Returns            : bool - true if component belongs to a listed game
+ * Description        : Map "pkg/.Activity" or a bare activity class such as
+ *                      "pkg.ui.MainActivity" to a gamelist package.
+ ***********************************************************************************/
+static bool match_component(const char* component, size_t len, char* package) {
+    if (len == 0 || len >= MAX_PACKAGE)
+        return false;
+
+    memcpy(package, component, len);
+    package[len] = '\0';
+
+    char* slash = strchr(package, '/');
+    if (slash) {
+        *slash = '\0';
+        return gamelist_contains(package);
+    }
+
+    // Class names only carry the package as a prefix, try every dotted prefix
+    for (char* dot; (dot = strrchr(package, '.'));) {
+        *dot = '\0';
+        if (gamelist_contains(package))
+            return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_event
+ * Inputs             : line (char *) - one line of event log output
+ * Returns            : bool - true if focused game changed
+ * Description        : Parse activity focus events such as
+ *                      wm_set_resumed_activity: [0,com.foo/.MainActivity,reason]
+ *                      and remember the focused game.
+ ***********************************************************************************/
+static bool parse_event(char* line) {
+    char* open = strchr(line, '[');
+    char* close = open ? strchr(open, ']') : NULL;
+    if (!close)
+        return false;
+
+    char game[MAX_PACKAGE] = {0};
+    char candidate[MAX_PACKAGE];
+    for (char* field = open + 1; field < close;) {
+        size_t len = strcspn(field, ",]");
+        if (memchr(field, '.', len) && match_component(field, len, candidate)) {
+            snprintf(game, sizeof(game), "%s", candidate);
+            break;
+        }
+        field += len + 1;
+    }
+
+    bool changed = !focus_known || strcmp(game, focused_game) != 0;
+    focus_known = true;
+    snprintf(focused_game, sizeof(focused_game), "%s", game);
+    return changed;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_screen_event
+ * Inputs             : line (const char *) - one line of event log output
+ * Returns            : int - 1 if screen turned on, 0 if off, -1 if not a screen event
+ * Description        : Parse interactive state events such as
+ *                      screen_toggled( 1234): 1
+ *                      power_screen_state( 1234): [1,2,0,0,120]
+ ***********************************************************************************/
+static int parse_screen_event(const char* line) {
+    const char* tag = strchr(line, '/');
+    if (!tag)
+        return -1;
+
+    tag++;
+    size_t tag_len = strcspn(tag, " (");
+    if (!(tag_len == 14 && strncmp(tag, "screen_toggled", 14) == 0) &&
+        !(tag_len == 18 && strncmp(tag, "power_screen_state", 18) == 0))
+        return -1;
+
+    const char* value = strstr(tag, "): ");
+    if (!value)
+        return -1;
+
+    value += 3;
+    if (*value == '[')
+        value++;
+    return atoi(value) != 0;
+}
+
+/***********************************************************************************
+ * Function Name      : stop_source
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Close stream, reap its process and schedule a restart with
+ *                      exponential backoff.
+ ***********************************************************************************/
+static void stop_source(void) {
+    if (source_fd != -1) {
+        event_loop_remove(source_fd);
+        close(source_fd);
+        source_fd = -1;
+    }
+
+    if (source_pid > 0) {
+        kill(-source_pid, SIGKILL);
+        while (waitpid(source_pid, NULL, 0) == -1 && errno == EINTR)
+            ;
+        source_pid = -1;
+    }
+
+    pending_len = 0;
+    focus_known = false;
+
+    // Only back off further while stream keeps dying shortly after start
+    long long now = now_ms();
+    if (now - started_at > RESTART_BACKOFF_MAX)
+        backoff = RESTART_BACKOFF_MIN;
+
+    restart_at = now + backoff;
+    log_nusantara(LOG_WARN, "Focus event stream closed, restarting in %dms", backoff);
+    backoff = (backoff > RESTART_BACKOFF_MAX / 2) ? RESTART_BACKOFF_MAX : backoff * 2;
+}
+
+/***********************************************************************************
+ * Function Name      : focus_monitor_start
+ * Inputs             : None
+ * Returns            : int - 0 on success, -1 on error
+ * Description        : Spawn a long-lived event log reader and register its stdout
+ *                      with event loop.
+ * Note               : focus_source may point to a stand-in executable printing
+ *                      canned event lines, it's run without arguments.
+ ***********************************************************************************/
+int focus_monitor_start(void) {
+    char* logcat_argv[] = {"logcat", "-b", "events", "-v", "brief", "-T", "1", "-s",
+                           "wm_set_resumed_activity:I", "am_set_resumed_activity:I",
+                           "am_focused_activity:I", "wm_on_resume_called:I", "screen_toggled:I",
+                           "power_screen_state:I", NULL};
+    char* standin_argv[] = {(char*)focus_source, NULL};
+    bool is_logcat = strcmp(focus_source, DEFAULT_FOCUS_SOURCE) == 0;
+
+    int fd;
+    pid_t pid = spawn_command(focus_source, is_logcat ? logcat_argv : standin_argv, &fd);
+    if (pid == -1) [[clang::unlikely]] {
+        restart_at = now_ms() + backoff;
+        return -1;
+    }
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    source_pid = pid;
+    source_fd = fd;
+    started_at = now_ms();
+
+    if (event_loop_add(fd, focus_monitor_handle) != 0) {
+        stop_source();
+        return -1;
+    }
+
+    log_nusantara(LOG_INFO, "Streaming activity focus events from %s (PID %d)", focus_source, pid);
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : focus_monitor_handle
+ * Inputs             : fd (int) - read end of event stream
+ * Returns            : bool - true if focused game or screen state changed
+ * Description        : Drain stream without blocking and parse complete lines.
+ ***********************************************************************************/
+bool focus_monitor_handle(int fd) {
+    bool changed = false;
+
+    while (1) {
+        ssize_t len = read(fd, pending + pending_len, sizeof(pending) - 1 - pending_len);
+        if (len == -1 && errno == EINTR)
+            continue;
+
+        if (len == -1 && errno == EAGAIN)
+            break;
+
+        if (len <= 0) {
+            stop_source();
+            return true;
+        }
+
+        pending_len += len;
+        pending[pending_len] = '\0';
+
+        char* cursor = pending;
+        char* newline;
+        while ((newline = strchr(cursor, '\n'))) {
+            *newline = '\0';
+            if (parse_screen_event(cursor) != -1) {
+                screen_events_seen = true;
+                changed = true;
+            } else if (parse_event(cursor)) {
+                changed = true;
+            }
+            cursor = newline + 1;
+        }
+
+        pending_len -= cursor - pending;
+        // A single line filled whole buffer, it's not an event we know
+        if (pending_len == sizeof(pending) - 1)
+            pending_len = 0;
+        memmove(pending, cursor, pending_len);
+    }
+
+    return changed;
+}
+
+/***********************************************************************************
+ * Function Name      : source_running
+ * Inputs             : None
+ * Returns            : bool - true if event stream is up
+ * Description        : Restart the stream once its backoff elapsed.
+ ***********************************************************************************/
+static bool source_running(void) {
+    if (source_fd != -1)
+        return true;
+
+    return restart_at != 0 && now_ms() >= restart_at && focus_monitor_start() == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : focus_monitor_game
+ * Inputs             : package (char **) - receives focused game package or NULL
+ * Returns            : int - 0 if event stream knows the focused activity
+ *                           -1 if stream is down or hasn't reported anything yet
+ * Description        : Foreground game as reported by activity focus events,
+ *                      restarting the stream once its backoff elapsed.
+ * Note               : Caller is responsible for freeing *package.
+ ***********************************************************************************/
+int focus_monitor_game(char** package) {
+    *package = NULL;
+
+    if (!source_running())
+        return -1;
+
+    if (!focus_known)
+        return -1;
+
+    if (focused_game[0])
+        *package = strdup(focused_game);
+
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : focus_monitor_screen_events
+ * Inputs             : None
+ * Returns            : bool - true if screen changes wake the event loop
+ * Description        : Stream must be up and have logged a screen change before,
+ *                      otherwise screen-on would go unnoticed while suspended.
+ ***********************************************************************************/
+bool focus_monitor_screen_events(void) {
+    return source_running() && screen_events_seen;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+// Foreground app adj, see ProcessList.FOREGROUND_APP_ADJ
+#define FOREGROUND_APP_ADJ 0
+
+// top-app rarely holds more than a handful of processes
+#define MAX_TOP_APP_PIDS 256
+
+typedef enum : char {
+    FG_UNPROBED,
+    FG_TOP_APP_CPUSET,
+    FG_OOM_SCORE,
+    FG_UNAVAILABLE
+} ForegroundBackend;
+
+const char* cpuset_root = DEFAULT_CPUSET_ROOT;
+static ForegroundBackend backend = FG_UNPROBED;
+
+/***********************************************************************************
+ * Function Name      : match_game
+ * Inputs             : pid (pid_t) - PID of candidate process
+ * Returns            : char * - dynamically allocated package name if process
+ *                      belongs to a game, NULL otherwise
+ * Description        : Map PID to package and check it against gamelist.
+ ***********************************************************************************/
+static char* match_game(pid_t pid) {
+    char name[MAX_PACKAGE];
+    if (get_process_name(pid, name, sizeof(name)) != 0)
+        return NULL;
+
+    // Secondary processes are named package:suffix
+    char* colon = strchr(name, ':');
+    if (colon)
+        *colon = '\0';
+
+    return gamelist_contains(name) ? strdup(name) : NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : scan_top_app_cpuset
+ * Inputs             : package (char **) - receives matched game package or NULL
+ * Returns            : int - 0 if cpuset was readable
+ *                           -1 otherwise
+ * Description        : ActivityManager moves foreground app into top-app cpuset,
+ *                      so only a handful of PIDs need to be checked.
+ ***********************************************************************************/
+static int scan_top_app_cpuset(char** package) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/top-app/cgroup.procs", cpuset_root);
+
+    long pids[MAX_TOP_APP_PIDS];
+    size_t count = 0;
+    if (read_node_list(path, pids, MAX_TOP_APP_PIDS, &count) == PARSE_ERR_IO)
+        return -1;
+
+    for (size_t i = 0; !*package && i < count; i++)
+        *package = match_game((pid_t)pids[i]);
+
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : scan_oom_score
+ * Inputs             : package (char **) - receives matched game package or NULL
+ * Returns            : int - 0 if /proc was readable
+ *                           -1 otherwise
+ * Description        : Fallback for devices without top-app cpuset, foreground app
+ *                      is the one running with oom_score_adj of 0.
+ ***********************************************************************************/
+static int scan_oom_score(char** package) {
+    DIR* dir = opendir(proc_root);
+    if (!dir)
+        return -1;
+
+    struct dirent* entry;
+    while (!*package && (entry = readdir(dir))) {
+        if (!isdigit((unsigned char)entry->d_name[0]))
+            continue;
+
+        char path[MAX_PATH_LENGTH];
+        snprintf(path, sizeof(path), "%s/%s/oom_score_adj", proc_root, entry->d_name);
+
+        long adj;
+        if (read_node_long(path, &adj) == PARSE_OK && adj == FOREGROUND_APP_ADJ)
+            *package = match_game(atoi(entry->d_name));
+    }
+
+    closedir(dir);
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : get_foreground_game
+ * Inputs             : package (char **) - receives matched game package or NULL
+ * Returns            : int - 0 if a native source answered
+ *                           -1 if no native source is available on this device
+ * Description        : Find foreground game without spawning dumpsys.
+ *                      Backend is probed once and reused for the next calls.
+ * Note               : Caller is responsible for freeing *package.
+ ***********************************************************************************/
+int get_foreground_game(char** package) {
+    *package = NULL;
+
+    switch (backend) {
+    case FG_TOP_APP_CPUSET:
+        if (scan_top_app_cpuset(package) == 0) [[clang::likely]]
+            return 0;
+        break;
+    case FG_OOM_SCORE:
+        if (scan_oom_score(package) == 0) [[clang::likely]]
+            return 0;
+        break;
+    case FG_UNAVAILABLE:
+        return -1;
+    default:
+        break;
+    }
+
+    // (Re)probe backend
+    if (scan_top_app_cpuset(package) == 0) {
+        backend = FG_TOP_APP_CPUSET;
+        log_nusantara(LOG_INFO, "Foreground detection: %s/top-app", cpuset_root);
+        return 0;
+    }
+
+    if (scan_oom_score(package) == 0) {
+        backend = FG_OOM_SCORE;
+        log_nusantara(LOG_INFO, "Foreground detection: oom_score_adj scan");
+        return 0;
+    }
+
+    backend = FG_UNAVAILABLE;
+    log_nusantara(LOG_WARN, "Foreground detection: falling back to dumpsys");
+    return -1;
+}
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <libgen.h>
+#include <sys/inotify.h>
+
+#define GAMELIST_SEPARATORS "|\r\n \t"
+
+// Open addressing hash set, package names point into one text buffer
+static char* text = NULL;
+static const char** slots = NULL;
+static size_t slot_mask = 0;
+static size_t entry_count = 0;
+
+static char list_path[MAX_PATH_LENGTH];
+static char list_name[MAX_PATH_LENGTH];
+
+/***********************************************************************************
+ * Function Name      : hash_name
+ * Inputs             : name (const char *) - package name
+ * Returns            : uint32_t - FNV-1a hash of name
+ * Description        : Hash function for gamelist index.
+ ***********************************************************************************/
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/***********************************************************************************
+ * Function Name      : read_list
+ * Inputs             : path (const char *) - path to gamelist file
+ *                      length (size_t *) - receives length of content
+ * Returns            : char * - dynamically allocated file content, NULL on error
+ * Description        : Read whole gamelist into a null terminated buffer.
+ ***********************************************************************************/
+static char* read_list(const char* path, size_t* length) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) [[clang::unlikely]] {
+        close(fd);
+        return NULL;
+    }
+
+    char* data = malloc(st.st_size + 1);
+    if (!data) [[clang::unlikely]] {
+        close(fd);
+        return NULL;
+    }
+
+    ssize_t total = 0, len;
+    while (total < st.st_size && (len = read(fd, data + total, st.st_size - total)) > 0)
+        total += len;
+    close(fd);
+
+    data[total] = '\0';
+    *length = total;
+    return data;
+}
+
+/***********************************************************************************
+ * Function Name      : gamelist_load
+ * Inputs             : path (const char *) - path to gamelist file
+ * Returns            : int - number of loaded packages
+ *                           -1 on error
+ * Description        : Loads gamelist into an in-memory hash set. Entries may be
+ *                      separated by '|' (format written by WebUI) or newline.
+ * Note               : Previous index is kept when the file can't be read.
+ ***********************************************************************************/
+int gamelist_load(const char* path) {
+    size_t length;
+    char* data = read_list(path, &length);
+    if (!data) [[clang::unlikely]] {
+        log_nusantara(LOG_ERROR, "Unable to open gamelist %s", path);
+        return -1;
+    }
+
+    // Terminate every entry in place, count them to size the table
+    size_t count = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (strchr(GAMELIST_SEPARATORS, data[i]))
+            data[i] = '\0';
+        else if (i == 0 || data[i - 1] == '\0')
+            count++;
+    }
+
+    // Keep load factor at or below 50%
+    size_t size = 16;
+    while (size < count * 2)
+        size <<= 1;
+
+    const char** table = calloc(size, sizeof(*table));
+    if (!table) [[clang::unlikely]] {
+        free(data);
+        return -1;
+    }
+
+    size_t loaded = 0;
+    for (char* name = data; name < data + length; name += strlen(name) + 1) {
+        if (!*name)
+            continue;
+
+        size_t slot = hash_name(name) & (size - 1);
+        while (table[slot] && strcmp(table[slot], name) != 0)
+            slot = (slot + 1) & (size - 1);
+
+        if (!table[slot]) {
+            table[slot] = name;
+            loaded++;
+        }
+    }
+
+    free(slots);
+    free(text);
+    text = data;
+    slots = table;
+    slot_mask = size - 1;
+    entry_count = loaded;
+
+    if (path != list_path)
+        snprintf(list_path, sizeof(list_path), "%s", path);
+
+    return (int)entry_count;
+}
+
+/***********************************************************************************
+ * Function Name      : gamelist_contains
+ * Inputs             : package (const char *) - package name to look up
+ * Returns            : bool - true if package is listed in gamelist
+ * Description        : Exact match lookup against loaded gamelist.
+ ***********************************************************************************/
+bool gamelist_contains(const char* package) {
+    if (!slots) [[clang::unlikely]]
+        return false;
+
+    for (size_t slot = hash_name(package) & slot_mask; slots[slot]; slot = (slot + 1) & slot_mask) {
+        if (strcmp(slots[slot], package) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : gamelist_watch_init
+ * Inputs             : None
+ * Returns            : int - inotify fd on success
+ *                           -1 if gamelist can't be watched
+ * Description        : Watch loaded gamelist so edits from WebUI are picked up
+ *                      without restarting daemon.
+ * Note               : Parent directory is watched, editors may replace the file.
+ ***********************************************************************************/
+int gamelist_watch_init(void) {
+    if (!list_path[0]) [[clang::unlikely]]
+        return -1;
+
+    char dir[MAX_PATH_LENGTH];
+    snprintf(dir, sizeof(dir), "%s", list_path);
+    snprintf(list_name, sizeof(list_name), "%s", basename(list_path));
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "inotify unavailable: %s", strerror(errno));
+        return -1;
+    }
+
+    if (inotify_add_watch(fd, dirname(dir), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        log_nusantara(LOG_WARN, "Unable to watch %s: %s", list_path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/***********************************************************************************
+ * Function Name      : gamelist_watch_handle
+ * Inputs             : fd (int) - inotify fd
+ * Returns            : bool - true if gamelist got reloaded
+ * Description        : Drain inotify events and rebuild index when gamelist changes.
+ ***********************************************************************************/
+bool gamelist_watch_handle(int fd) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+
+    ssize_t len;
+    while ((len = read(fd, buf, sizeof(buf))) > 0) {
+        for (char* ptr = buf; ptr < buf + len;) {
+            struct inotify_event* ev = (struct inotify_event*)ptr;
+            if (ev->len && strcmp(ev->name, list_name) == 0)
+                changed = true;
+
+            ptr += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+
+    if (!changed)
+        return false;
+
+    int count = gamelist_load(list_path);
+    if (count < 0)
+        return false;
+
+    log_nusantara(LOG_INFO, "Gamelist reloaded, %d packages", count);
+    return true;
+}
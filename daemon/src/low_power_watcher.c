@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <sys/inotify.h>
+
+#define SETTINGS_DIR "/data/system/users/0"
+#define SETTINGS_GLOBAL "settings_global.xml"
+#define MAX_SETTINGS_SIZE (512 * 1024)
+
+static int inotify_fd = -1;
+static bool store_changed = true;
+static int cached_state = -1;
+
+/***********************************************************************************
+ * Function Name      : low_power_watch_init
+ * Inputs             : None
+ * Returns            : int - inotify fd on success
+ *                           -1 if settings store can't be watched
+ * Description        : Watch global settings store so battery saver state only gets
+ *                      re-evaluated when it actually changes.
+ * Note               : SettingsProvider replaces the file through AtomicFile, so we
+ *                      watch the parent directory and filter by file name.
+ ***********************************************************************************/
+int low_power_watch_init(void) {
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "inotify unavailable: %s", strerror(errno));
+        return -1;
+    }
+
+    if (inotify_add_watch(inotify_fd, SETTINGS_DIR, IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        log_nusantara(LOG_WARN, "Unable to watch %s: %s", SETTINGS_DIR, strerror(errno));
+        close(inotify_fd);
+        inotify_fd = -1;
+        return -1;
+    }
+
+    log_nusantara(LOG_INFO, "Watching %s/%s for battery saver changes", SETTINGS_DIR, SETTINGS_GLOBAL);
+    return inotify_fd;
+}
+
+/***********************************************************************************
+ * Function Name      : low_power_watch_handle
+ * Inputs             : fd (int) - inotify fd
+ * Returns            : bool - true if global settings got rewritten
+ * Description        : Drain inotify events and mark cached state as stale.
+ ***********************************************************************************/
+bool low_power_watch_handle(int fd) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+
+    ssize_t len;
+    while ((len = read(fd, buf, sizeof(buf))) > 0) {
+        for (char* ptr = buf; ptr < buf + len;) {
+            struct inotify_event* ev = (struct inotify_event*)ptr;
+            if (ev->len && strcmp(ev->name, SETTINGS_GLOBAL) == 0)
+                changed = true;
+
+            ptr += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+
+    if (changed)
+        store_changed = true;
+
+    return changed;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_settings_xml
+ * Inputs             : None
+ * Returns            : int - 1 if battery saver enabled, 0 if disabled
+ *                           -1 if store is unreadable or binary (ABX)
+ * Description        : Look up low_power value straight from text XML store.
+ ***********************************************************************************/
+static int parse_settings_xml(void) {
+    int fd = open(SETTINGS_DIR "/" SETTINGS_GLOBAL, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return -1;
+
+    char* data = malloc(MAX_SETTINGS_SIZE);
+    if (!data) [[clang::unlikely]] {
+        close(fd);
+        return -1;
+    }
+
+    ssize_t total = 0, len;
+    while (total < MAX_SETTINGS_SIZE - 1 && (len = read(fd, data + total, MAX_SETTINGS_SIZE - 1 - total)) > 0)
+        total += len;
+    close(fd);
+    data[total] = '\0';
+
+    // Android 12+ may store settings as Android Binary XML
+    int state = -1;
+    if (total > 0 && strncmp(data, "<?xml", 5) == 0) {
+        char* setting = strstr(data, "name=\"low_power\"");
+        char* tag_end = setting ? strchr(setting, '>') : NULL;
+        char* value = setting ? strstr(setting, " value=\"") : NULL;
+
+        if (value && (!tag_end || value < tag_end))
+            state = (value[8] == '1');
+        else if (setting)
+            state = 0;
+    }
+
+    free(data);
+    return state;
+}
+
+/***********************************************************************************
+ * Function Name      : read_low_power_state
+ * Inputs             : None
+ * Returns            : int - 1 if battery saver enabled, 0 if disabled, -1 on error
+ * Description        : Return cached battery saver state while settings store is
+ *                      unchanged, re-evaluate it only after a change.
+ * Note               : Without inotify watch, state is re-evaluated on every call.
+ ***********************************************************************************/
+int read_low_power_state(void) {
+    if (inotify_fd != -1 && !store_changed && cached_state != -1) [[clang::likely]]
+        return cached_state;
+
+    int state = parse_settings_xml();
+    if (state == -1)
+        state = dumpsys_low_power_state();
+
+    store_changed = false;
+    cached_state = state;
+    return state;
+}
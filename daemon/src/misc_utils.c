@@ -15,6 +15,9 @@
  */
 
 #include <nusantara.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
 
 /***********************************************************************************
  * Function Name      : trim_newline
@@ -35,12 +38,13 @@
 }
 
 /***********************************************************************************
- * Function Name      : notify
+ * Function Name      : post_notification
  * Inputs             : message (char *) - Message to display
  * Returns            : None
- * Description        : Push a notification.
+ * Description        : Push a notification right away.
+ * Note               : Blocks until cmd returns, use notify() instead.
  ***********************************************************************************/
-void notify(const char* message) {
+void post_notification(const char* message) {
     int exit =
         systemv("su -lp 2000 -c \"/system/bin/cmd notification post -t '%s' '%s' '%s'\" >/dev/null", NOTIFY_TITLE, LOG_TAG, message);
 
@@ -50,12 +54,13 @@ void notify(const char* message) {
 }
 
 /***********************************************************************************
- * Function Name      : toast
+ * Function Name      : show_toast
  * Inputs             : message (const char *) - Message to display
  * Returns            : None
  * Description        : Display a toast notification using velocity.toast app.
+ * Note               : Use toast() instead, it also hides the toast app afterwards.
  ***********************************************************************************/
-void toast(const char* message) {
+void show_toast(const char* message) {
     int ret = systemv(
         "su -lp 2000 -c \"/system/bin/am start "
         "-a android.intent.action.MAIN "
@@ -68,8 +73,15 @@ void toast(const char* message) {
     if (ret != 0) [[clang::unlikely]] {
         log_nusantara(LOG_WARN, "Unable to show toast message: %s", message);
     }
+}
 
-    sleep(2);
+/***********************************************************************************
+ * Function Name      : hide_toast
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Stop velocity.toast app once its toast has been shown.
+ ***********************************************************************************/
+void hide_toast(void) {
     systemv("am force-stop velocity.toast");
 }
 
@@ -108,24 +120,64 @@ char* timern(void) {
     return timestamp;
 }
 
+// Set by sighandler(), acted on by main loop outside of signal context
+static volatile sig_atomic_t exit_signal = 0;
+static int exit_pipe[2] = {-1, -1};
+
 /***********************************************************************************
  * Function Name      : sighandler
  * Inputs             : int signal - exit signal
  * Returns            : None
- * Description        : Handle exit signal.
+ * Description        : Handle exit signal. Only async-signal-safe work here, the
+ *                      pipe wakes main loop which restores knobs and exits.
  ***********************************************************************************/
-[[noreturn]] void sighandler(const int signal) {
-    switch (signal) {
-    case SIGTERM:
-        log_nusantara(LOG_INFO, "Received SIGTERM, exiting.");
-        break;
-    case SIGINT:
-        log_nusantara(LOG_INFO, "Received SIGINT, exiting.");
-        break;
+void sighandler(const int signal) {
+    exit_signal = signal;
+
+    if (exit_pipe[1] != -1) {
+        int saved_errno = errno;
+        (void)!write(exit_pipe[1], "", 1);
+        errno = saved_errno;
     }
+}
 
-    // Exit gracefully
-    _exit(EXIT_SUCCESS);
+/***********************************************************************************
+ * Function Name      : exit_signal_init
+ * Inputs             : None
+ * Returns            : int - read end of wakeup pipe to register with event loop
+ *                           -1 if pipe is unavailable, flag is still checked
+ * Description        : Install SIGINT and SIGTERM handlers.
+ ***********************************************************************************/
+int exit_signal_init(void) {
+    if (pipe2(exit_pipe, O_CLOEXEC | O_NONBLOCK) == -1) [[clang::unlikely]] {
+        exit_pipe[0] = exit_pipe[1] = -1;
+        log_nusantara(LOG_WARN, "Unable to create signal pipe: %s", strerror(errno));
+    }
+
+    signal(SIGINT, sighandler);
+    signal(SIGTERM, sighandler);
+    return exit_pipe[0];
+}
+
+/***********************************************************************************
+ * Function Name      : exit_signal_handle
+ * Inputs             : fd (int) - read end of wakeup pipe
+ * Returns            : bool - true, main loop has to act on the signal
+ ***********************************************************************************/
+bool exit_signal_handle(int fd) {
+    char buf[16];
+    while (read(fd, buf, sizeof(buf)) > 0)
+        ;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : exit_signal_pending
+ * Inputs             : None
+ * Returns            : int - signal asking daemon to exit, 0 if none
+ ***********************************************************************************/
+int exit_signal_pending(void) {
+    return exit_signal;
 }
 
 /***********************************************************************************
@@ -35,7 +35,7 @@ MLBBState handle_mlbb(const char* gamestart) {
 
     // Check if cached PID is still valid
     if (mlbb_pid != 0) {
-        if (kill(mlbb_pid, 0) == 0) [[clang::likely]] {
+        if (process_alive(mlbb_pid)) [[clang::likely]] {
             return MLBB_RUNNING;
         }
 
@@ -47,9 +47,10 @@ MLBBState handle_mlbb(const char* gamestart) {
     snprintf(mlbb_proc, sizeof(mlbb_proc), "%s%s", gamestart, ":UnityKillsMe");
 
     // Fetch new PID if cache is invalid
-    mlbb_pid = pidof(mlbb_proc);
+    mlbb_pid = pidof_exact(mlbb_proc);
     if (mlbb_pid != 0) {
         log_nusantara(LOG_INFO, "Boosting MLBB process %s", mlbb_proc);
+        watch_process_exit(mlbb_pid);
         return MLBB_RUNNING;
     }
 
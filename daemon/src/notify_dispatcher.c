@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <pthread.h>
+
+#define QUEUE_SIZE 8
+
+typedef enum : char {
+    MESSAGE_NOTIFY,
+    MESSAGE_TOAST
+} MessageType;
+
+typedef struct {
+    MessageType type;
+    char text[MAX_OUTPUT_LENGTH];
+} Message;
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t dispatcher;
+static bool running = false;
+static bool stopping = false;
+
+static Message queue[QUEUE_SIZE];
+static size_t head = 0;
+static size_t count = 0;
+static bool toast_pending = false;
+
+/***********************************************************************************
+ * Function Name      : queue_remove
+ * Inputs             : index (size_t) - position relative to queue head
+ * Returns            : None
+ * Description        : Remove a message from the middle of the queue.
+ * Note               : Caller must hold queue_lock.
+ ***********************************************************************************/
+static void queue_remove(size_t index) {
+    for (size_t i = index; i + 1 < count; i++)
+        queue[(head + i) % QUEUE_SIZE] = queue[(head + i + 1) % QUEUE_SIZE];
+    count--;
+}
+
+/***********************************************************************************
+ * Function Name      : wait_toast_duration
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Keep toast on screen for TOAST_DURATION seconds, or until a
+ *                      newer toast replaces it.
+ * Note               : Caller must hold queue_lock.
+ ***********************************************************************************/
+static void wait_toast_duration(void) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += TOAST_DURATION;
+
+    while (!toast_pending && !stopping) {
+        if (pthread_cond_timedwait(&queue_cond, &queue_lock, &deadline) != 0)
+            break;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : dispatcher_thread
+ * Inputs             : arg (void *) - unused
+ * Returns            : void * - always NULL
+ * Description        : Deliver queued messages in order, off the main loop.
+ ***********************************************************************************/
+static void* dispatcher_thread(void* arg) {
+    (void)arg;
+
+    pthread_mutex_lock(&queue_lock);
+    while (1) {
+        while (count == 0 && !stopping)
+            pthread_cond_wait(&queue_cond, &queue_lock);
+
+        if (count == 0)
+            break;
+
+        Message message = queue[head];
+        head = (head + 1) % QUEUE_SIZE;
+        count--;
+        if (message.type == MESSAGE_TOAST)
+            toast_pending = false;
+
+        pthread_mutex_unlock(&queue_lock);
+
+        if (message.type == MESSAGE_NOTIFY) {
+            post_notification(message.text);
+            pthread_mutex_lock(&queue_lock);
+            continue;
+        }
+
+        show_toast(message.text);
+        pthread_mutex_lock(&queue_lock);
+        wait_toast_duration();
+        pthread_mutex_unlock(&queue_lock);
+        hide_toast();
+        pthread_mutex_lock(&queue_lock);
+    }
+    pthread_mutex_unlock(&queue_lock);
+
+    return NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : notify_dispatcher_stop
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Deliver whatever is still queued and stop dispatcher thread.
+ * Note               : Registered with atexit(), so messages sent right before the
+ *                      daemon exits still go out.
+ ***********************************************************************************/
+void notify_dispatcher_stop(void) {
+    pthread_mutex_lock(&queue_lock);
+    if (!running) {
+        pthread_mutex_unlock(&queue_lock);
+        return;
+    }
+
+    stopping = true;
+    pthread_cond_broadcast(&queue_cond);
+    pthread_mutex_unlock(&queue_lock);
+
+    pthread_join(dispatcher, NULL);
+    running = false;
+}
+
+/***********************************************************************************
+ * Function Name      : notify_dispatcher_start
+ * Inputs             : None
+ * Returns            : int - 0 on success, -1 on error
+ * Description        : Start background thread delivering notifications and toasts.
+ *                      Until it runs, notify() and toast() deliver synchronously.
+ * Note               : Must be called after daemon(), threads don't survive fork.
+ ***********************************************************************************/
+int notify_dispatcher_start(void) {
+    if (pthread_create(&dispatcher, NULL, dispatcher_thread, NULL) != 0) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "Unable to start notification dispatcher, delivering synchronously");
+        return -1;
+    }
+
+    running = true;
+    atexit(notify_dispatcher_stop);
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : dispatch_message
+ * Inputs             : type (MessageType) - notification or toast
+ *                      text (const char *) - message to deliver
+ * Returns            : bool - true if message was queued
+ *                             false if dispatcher is not running
+ * Description        : Queue a message and return immediately. A new toast
+ *                      replaces any toast still waiting, identical pending
+ *                      notifications are merged, and when queue is full the
+ *                      oldest message is dropped.
+ ***********************************************************************************/
+static bool dispatch_message(MessageType type, const char* text) {
+    pthread_mutex_lock(&queue_lock);
+    if (!running || stopping) {
+        pthread_mutex_unlock(&queue_lock);
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        Message* pending = &queue[(head + i) % QUEUE_SIZE];
+        if (pending->type != type)
+            continue;
+
+        if (type == MESSAGE_TOAST) {
+            log_nusantara(LOG_DEBUG, "Dropping stale toast: %s", pending->text);
+            queue_remove(i);
+            break;
+        }
+
+        if (strcmp(pending->text, text) == 0) {
+            pthread_mutex_unlock(&queue_lock);
+            return true;
+        }
+    }
+
+    if (count == QUEUE_SIZE) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "Notification queue full, dropping: %s", queue[head].text);
+        if (queue[head].type == MESSAGE_TOAST)
+            toast_pending = false;
+        head = (head + 1) % QUEUE_SIZE;
+        count--;
+    }
+
+    Message* slot = &queue[(head + count) % QUEUE_SIZE];
+    slot->type = type;
+    snprintf(slot->text, sizeof(slot->text), "%s", text);
+    count++;
+
+    if (type == MESSAGE_TOAST)
+        toast_pending = true;
+
+    pthread_cond_broadcast(&queue_cond);
+    pthread_mutex_unlock(&queue_lock);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : notify
+ * Inputs             : message (char *) - Message to display
+ * Returns            : None
+ * Description        : Push a notification.
+ ***********************************************************************************/
+void notify(const char* message) {
+    if (!dispatch_message(MESSAGE_NOTIFY, message))
+        post_notification(message);
+}
+
+/***********************************************************************************
+ * Function Name      : toast
+ * Inputs             : message (const char *) - Message to display
+ * Returns            : None
+ * Description        : Display a toast notification using velocity.toast app.
+ ***********************************************************************************/
+void toast(const char* message) {
+    if (dispatch_message(MESSAGE_TOAST, message))
+        return;
+
+    show_toast(message);
+    sleep(TOAST_DURATION);
+    hide_toast();
+}
@@ -15,10 +15,38 @@
  */
 
 #include <nusantara.h>
+#include <errno.h>
+#include <sys/inotify.h>
+#include <nusantara_profiler.h>
 
 bool (*get_screenstate)(void) = get_screenstate_normal;
 bool (*get_low_power_state)(void) = get_low_power_state_normal;
 
+// Profiler config is read once and refreshed when WebUI edits it
+static ProfilerConfig profiler_config;
+static bool profiler_config_loaded = false;
+
+/***********************************************************************************
+ * Function Name      : log_knob_error
+ * Inputs             : path (const char *) - knob that failed
+ *                      error (int) - errno of failed write
+ * Returns            : None
+ * Description        : Report knobs that exist but refuse our value.
+ ***********************************************************************************/
+static void log_knob_error(const char* path, int error) {
+    log_nusantara(LOG_DEBUG, "Unable to write %s: %s", path, strerror(error));
+}
+
+/***********************************************************************************
+ * Function Name      : run_profiler_command
+ * Inputs             : argv (char * const []) - command requested by a profile
+ * Returns            : int - exit status, -1 if it failed or timed out
+ * Description        : Keep profile commands under the executor deadline.
+ ***********************************************************************************/
+static int run_profiler_command(char* const argv[]) {
+    return run_command(argv[0], argv, COMMAND_TIMEOUT_MS, NULL);
+}
+
 /***********************************************************************************
  * Function Name      : run_profiler
  * Inputs             : int - 0 for perfcommon
@@ -32,15 +60,102 @@ void run_profiler(const int profile) {
     is_kanged();
 
     if (profile == 1) {
-        write2file(GAME_INFO, false, false, "%s %d %d\n", gamestart, game_pid, uidof(game_pid));
+        PackageInfo info;
+        int uid = package_cache_lookup(gamestart, &info) == 0 && info.uid != -1 ? info.uid : uidof(game_pid);
+        write2file(GAME_INFO, false, false, "%s %d %d\n", gamestart, game_pid, uid);
     } else {
         write2file(GAME_INFO, false, false, "NULL 0 0\n");
     }
 
     write2file(PROFILE_MODE, false, false, "%d\n", profile);
-    if (systemv("nusantara_profiler %d", profile)) {
+
+    if (!profiler_config_loaded) {
+        profiler_load_config(&profiler_config);
+        knob_set_error_handler(log_knob_error);
+        profiler_set_command_hook(run_profiler_command);
+        profiler_config_loaded = true;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (profiler_apply(profile, &profiler_config) != 0) {
         log_nusantara(LOG_ERROR, "Unable to execute profiler changes to %d", profile);
+        return;
     }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    KnobStats stats;
+    knob_get_stats(&stats);
+    long long elapsed_us = (end.tv_sec - start.tv_sec) * 1000000LL + (end.tv_nsec - start.tv_nsec) / 1000;
+    log_nusantara(LOG_DEBUG, "Profile %d applied in %lld us: %u written, %u skipped, %u missing, %u failed, %u syscalls",
+                  profile, elapsed_us, stats.written, stats.skipped, stats.missing, stats.failed, stats.syscalls);
+}
+
+/***********************************************************************************
+ * Function Name      : restore_profiler
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Hand every tuned knob back with its stock value, used when
+ *                      daemon stops managing profiles.
+ ***********************************************************************************/
+void restore_profiler(void) {
+    knob_set_error_handler(log_knob_error);
+    profiler_restore();
+
+    KnobStats stats;
+    knob_get_stats(&stats);
+    log_nusantara(LOG_INFO, "Restored stock values: %u written, %u skipped, %u failed", stats.written, stats.skipped,
+                  stats.failed);
+}
+
+/***********************************************************************************
+ * Function Name      : profiler_config_watch_init
+ * Inputs             : None
+ * Returns            : int - inotify fd to register with event loop
+ *                           -1 if config directory can't be watched
+ * Description        : Watch module config directory so profiler settings changed
+ *                      from WebUI apply on next profile switch.
+ ***********************************************************************************/
+int profiler_config_watch_init(void) {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "inotify unavailable: %s", strerror(errno));
+        return -1;
+    }
+
+    if (inotify_add_watch(fd, MODULE_CONFIG_DIR, IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        log_nusantara(LOG_WARN, "Unable to watch %s: %s", MODULE_CONFIG_DIR, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/***********************************************************************************
+ * Function Name      : profiler_config_watch_handle
+ * Inputs             : fd (int) - inotify fd
+ * Returns            : bool - always false, a config edit doesn't need a re-check
+ * Description        : Drain inotify events and drop cached profiler config when
+ *                      one of its files changes.
+ ***********************************************************************************/
+bool profiler_config_watch_handle(int fd) {
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    ssize_t len;
+    while ((len = read(fd, buf, sizeof(buf))) > 0) {
+        for (char* ptr = buf; ptr < buf + len;) {
+            struct inotify_event* ev = (struct inotify_event*)ptr;
+            if (ev->len && profiler_is_config_file(ev->name) && profiler_config_loaded) {
+                log_nusantara(LOG_DEBUG, "Profiler config %s changed", ev->name);
+                profiler_config_loaded = false;
+            }
+
+            ptr += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+
+    return false;
 }
 
 /***********************************************************************************
@@ -50,12 +165,19 @@ void run_profiler(const int profile) {
  * Description        : Searches for the currently visible application that matches
  *                      any package name listed in gamelist.
  *                      This helps identify if a specific game is running in the foreground.
- *                      Uses dumpsys to retrieve visible apps and filters by packages
- *                      listed in Gamelist.
+ *                      Prefers activity focus event stream, then top-app cpuset (or
+ *                      oom_score_adj), dumpsys is only used when none is available.
  * Note               : Caller is responsible for freeing the returned string.
  ***********************************************************************************/
 char* get_gamestart(void) {
-    return execute_command("dumpsys window visible-apps | grep 'package=.* ' | grep -Eo -f %s", GAMELIST);
+    char* package;
+    if (focus_monitor_game(&package) == 0) [[clang::likely]]
+        return package;
+
+    if (get_foreground_game(&package) == 0)
+        return package;
+
+    return dumpsys_visible_game();
 }
 
 /***********************************************************************************
@@ -63,7 +185,8 @@ char* get_gamestart(void) {
  * Inputs             : None
  * Returns            : bool - true if screen was awake
  *                             false if screen was asleep
- * Description        : Retrieves the current screen wakefulness state from dumpsys command.
+ * Description        : Retrieves the current screen state from kernel display nodes,
+ *                      falling back to dumpsys power when none is usable.
  * Note               : In repeated failures up to 6, this function will skip fetch routine
  *                      and just return true all time using function pointer.
  *                      Never call this function, call get_screenstate() instead.
@@ -71,12 +194,10 @@ char* get_gamestart(void) {
 bool get_screenstate_normal(void) {
     static char fetch_failed = 0;
 
-    char* screenstate = execute_command("dumpsys power | grep -Eo 'mWakefulness=Awake|mWakefulness=Asleep' "
-                                        "| awk -F'=' '{print $2}'");
-
-    if (screenstate) [[clang::likely]] {
+    int screenstate = read_screen_state();
+    if (screenstate != -1) [[clang::likely]] {
         fetch_failed = 0;
-        return IS_AWAKE(screenstate);
+        return screenstate;
     }
 
     fetch_failed++;
@@ -97,8 +218,8 @@ bool get_screenstate_normal(void) {
  * Inputs             : None
  * Returns            : bool - true if Battery Saver is enabled
  *                             false otherwise
- * Description        : Checks if the device's Battery Saver mode is enabled by using
- *                      global db or dumpsys power.
+ * Description        : Checks if the device's Battery Saver mode is enabled. State is
+ *                      cached and only re-evaluated when global settings change.
  * Note               : In repeated failures up to 6, this function will skip fetch routine
  *                      and just return false all time using function pointer.
  *                      Never call this function, call get_low_power_state() instead.
@@ -106,16 +227,10 @@ bool get_screenstate_normal(void) {
 bool get_low_power_state_normal(void) {
     static char fetch_failed = 0;
 
-    char* low_power = execute_direct("/system/bin/settings", "settings", "get", "global", "low_power", NULL);
-    if (!low_power) {
-        low_power = execute_command("dumpsys power | grep -Eo "
-                                    "'mSettingBatterySaverEnabled=true|mSettingBatterySaverEnabled=false' | "
-                                    "awk -F'=' '{print $2}'");
-    }
-
-    if (low_power) [[clang::likely]] {
+    int low_power = read_low_power_state();
+    if (low_power != -1) [[clang::likely]] {
         fetch_failed = 0;
-        return IS_LOW_POWER(low_power);
+        return low_power;
     }
 
     fetch_failed++;
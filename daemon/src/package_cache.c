@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#define PACKAGE_CACHE_MAGIC 0x43504b4e // "NKPC"
+#define PACKAGE_CACHE_VERSION 1
+#define PACKAGE_CACHE_SIZE 64
+#define APP_INSTALL_DIR "/data/app"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t record_size;
+} CacheHeader;
+
+// On-disk record, native library dir is derived from apk_dir and abi
+typedef struct {
+    char package[MAX_PACKAGE];
+    char apk_dir[MAX_PATH_LENGTH];
+    char abi[16];
+    int32_t uid;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+    int64_t last_used;
+} CacheRecord;
+
+// Preferred first, a 32-bit only game on a 64-bit device ships lib/arm
+static const char* const abi_dirs[] = {"arm64", "arm", "x86_64", "x86"};
+
+static CacheRecord records[PACKAGE_CACHE_SIZE];
+static size_t record_count = 0;
+
+/***********************************************************************************
+ * Function Name      : package_cache_load
+ * Inputs             : None
+ * Returns            : int - number of cached packages, -1 if cache is unusable
+ * Description        : Load package metadata saved by previous runs. A missing,
+ *                      truncated or foreign file simply starts an empty cache.
+ ***********************************************************************************/
+int package_cache_load(void) {
+    record_count = 0;
+
+    int fd = open(PACKAGE_CACHE, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return errno == ENOENT ? 0 : -1;
+
+    CacheHeader header;
+    bool valid = read(fd, &header, sizeof(header)) == sizeof(header) && header.magic == PACKAGE_CACHE_MAGIC &&
+                 header.version == PACKAGE_CACHE_VERSION && header.record_size == sizeof(CacheRecord) &&
+                 header.count <= PACKAGE_CACHE_SIZE;
+
+    if (valid) {
+        ssize_t size = (ssize_t)(header.count * sizeof(CacheRecord));
+        valid = read(fd, records, size) == size;
+    }
+    close(fd);
+
+    if (!valid) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "Package cache is invalid, starting empty");
+        return -1;
+    }
+
+    record_count = header.count;
+    for (size_t i = 0; i < record_count; i++) {
+        records[i].package[MAX_PACKAGE - 1] = '\0';
+        records[i].apk_dir[MAX_PATH_LENGTH - 1] = '\0';
+        records[i].abi[sizeof(records[i].abi) - 1] = '\0';
+    }
+
+    log_nusantara(LOG_DEBUG, "Loaded %zu packages from package cache", record_count);
+    return (int)record_count;
+}
+
+/***********************************************************************************
+ * Function Name      : package_cache_save
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Write cache to a temporary file and rename it over the old
+ *                      one, so a crash never leaves a half written cache behind.
+ ***********************************************************************************/
+static void package_cache_save(void) {
+    char tmp_path[MAX_PATH_LENGTH];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", PACKAGE_CACHE);
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd == -1) {
+        log_nusantara(LOG_WARN, "Unable to write package cache: %s", strerror(errno));
+        return;
+    }
+
+    CacheHeader header = {
+        .magic = PACKAGE_CACHE_MAGIC,
+        .version = PACKAGE_CACHE_VERSION,
+        .count = (uint32_t)record_count,
+        .record_size = sizeof(CacheRecord),
+    };
+
+    ssize_t size = (ssize_t)(record_count * sizeof(CacheRecord));
+    bool written = write(fd, &header, sizeof(header)) == sizeof(header) && write(fd, records, size) == size;
+    close(fd);
+
+    if (!written || rename(tmp_path, PACKAGE_CACHE) == -1) {
+        log_nusantara(LOG_WARN, "Unable to write package cache");
+        unlink(tmp_path);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : find_apk_dir
+ * Inputs             : package (const char *) - package name
+ *                      apk_dir (char *) - receives directory holding base.apk
+ *                      size (size_t) - size of apk_dir
+ * Returns            : bool - true if package was found under /data/app
+ * Description        : Look for <package>-<suffix> directly under /data/app, or one
+ *                      level deeper inside ~~<random> directories on Android 11+.
+ ***********************************************************************************/
+static bool find_apk_dir(const char* package, char* apk_dir, size_t size) {
+    DIR* dir = opendir(APP_INSTALL_DIR);
+    if (!dir)
+        return false;
+
+    size_t package_len = strlen(package);
+    bool found = false;
+    struct dirent* entry;
+    while (!found && (entry = readdir(dir))) {
+        if (strncmp(entry->d_name, package, package_len) == 0 && entry->d_name[package_len] == '-') {
+            snprintf(apk_dir, size, "%s/%s", APP_INSTALL_DIR, entry->d_name);
+            found = true;
+            break;
+        }
+
+        if (strncmp(entry->d_name, "~~", 2) != 0)
+            continue;
+
+        char parent[MAX_PATH_LENGTH];
+        snprintf(parent, sizeof(parent), "%s/%s", APP_INSTALL_DIR, entry->d_name);
+        DIR* inner = opendir(parent);
+        if (!inner)
+            continue;
+
+        struct dirent* child;
+        while ((child = readdir(inner))) {
+            if (strncmp(child->d_name, package, package_len) == 0 && child->d_name[package_len] == '-') {
+                snprintf(apk_dir, size, "%s/%s", parent, child->d_name);
+                found = true;
+                break;
+            }
+        }
+        closedir(inner);
+    }
+    closedir(dir);
+
+    return found;
+}
+
+/***********************************************************************************
+ * Function Name      : query_apk_dir
+ * Inputs             : package (const char *) - package name
+ *                      apk_dir (char *) - receives directory holding base.apk
+ *                      size (size_t) - size of apk_dir
+ * Returns            : bool - true if package manager knows the package
+ * Description        : Ask package manager, needed for apps living outside
+ *                      /data/app such as updated system apps.
+ ***********************************************************************************/
+static bool query_apk_dir(const char* package, char* apk_dir, size_t size) {
+    char* argv[] = {"cmd", "package", "path", (char*)package, NULL};
+    CommandResult result;
+
+    if (run_command("/system/bin/cmd", argv, COMMAND_TIMEOUT_MS, &result) != 0 || !result.output ||
+        strncmp(result.output, "package:", 8) != 0) {
+        free_command_result(&result);
+        return false;
+    }
+
+    // First line is base.apk, splits follow in the same directory
+    char* apk_path = result.output + 8;
+    apk_path[strcspn(apk_path, "\r\n")] = '\0';
+    char* last_slash = strrchr(apk_path, '/');
+    if (last_slash)
+        *last_slash = '\0';
+
+    snprintf(apk_dir, size, "%s", apk_path);
+    free_command_result(&result);
+    return last_slash != NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : has_shared_library
+ * Inputs             : path (const char *) - directory to look into
+ * Returns            : bool - true if directory holds a .so file
+ * Description        : Apps with extractNativeLibs=false keep an empty lib dir.
+ ***********************************************************************************/
+static bool has_shared_library(const char* path) {
+    DIR* dir = opendir(path);
+    if (!dir)
+        return false;
+
+    bool found = false;
+    struct dirent* entry;
+    while (!found && (entry = readdir(dir)))
+        found = strstr(entry->d_name, ".so") != NULL;
+
+    closedir(dir);
+    return found;
+}
+
+/***********************************************************************************
+ * Function Name      : resolve_record
+ * Inputs             : package (const char *) - package name
+ *                      record (CacheRecord *) - receives resolved metadata
+ * Returns            : bool - true if package is installed
+ * Description        : Gather metadata of a package seen for the first time, or
+ *                      whose install directory changed since it was cached.
+ ***********************************************************************************/
+static bool resolve_record(const char* package, CacheRecord* record) {
+    memset(record, 0, sizeof(*record));
+    snprintf(record->package, sizeof(record->package), "%s", package);
+
+    if (!find_apk_dir(package, record->apk_dir, sizeof(record->apk_dir)) &&
+        !query_apk_dir(package, record->apk_dir, sizeof(record->apk_dir))) {
+        log_nusantara(LOG_WARN, "Unable to locate APK of %s", package);
+        return false;
+    }
+
+    struct stat st;
+    if (stat(record->apk_dir, &st) == -1) {
+        log_nusantara(LOG_WARN, "Unable to stat %s: %s", record->apk_dir, strerror(errno));
+        return false;
+    }
+    record->mtime_sec = st.st_mtim.tv_sec;
+    record->mtime_nsec = st.st_mtim.tv_nsec;
+    record->uid = package_uid(package);
+
+    for (size_t i = 0; i < sizeof(abi_dirs) / sizeof(abi_dirs[0]); i++) {
+        char lib_dir[MAX_PATH_LENGTH];
+        snprintf(lib_dir, sizeof(lib_dir), "%s/lib/%s", record->apk_dir, abi_dirs[i]);
+        if (has_shared_library(lib_dir)) {
+            snprintf(record->abi, sizeof(record->abi), "%s", abi_dirs[i]);
+            break;
+        }
+    }
+
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : record_is_fresh
+ * Inputs             : record (const CacheRecord *) - cached metadata
+ * Returns            : bool - true if install directory is unchanged
+ * Description        : An update or reinstall moves the app to a new directory,
+ *                      a single stat() tells whether cached metadata still holds.
+ ***********************************************************************************/
+static bool record_is_fresh(const CacheRecord* record) {
+    struct stat st;
+    return stat(record->apk_dir, &st) == 0 && st.st_mtim.tv_sec == record->mtime_sec &&
+           st.st_mtim.tv_nsec == record->mtime_nsec;
+}
+
+/***********************************************************************************
+ * Function Name      : package_cache_lookup
+ * Inputs             : package (const char *) - package name
+ *                      info (PackageInfo *) - receives package metadata
+ * Returns            : int - 0 on success, -1 if package is not installed
+ * Description        : Fetch APK directory, UID, native library directory and ABI
+ *                      of a package. Packages seen before are answered from cache
+ *                      after a stat(), others are resolved and saved to disk.
+ ***********************************************************************************/
+int package_cache_lookup(const char* package, PackageInfo* info) {
+    CacheRecord* record = NULL;
+    for (size_t i = 0; i < record_count; i++) {
+        if (strcmp(records[i].package, package) == 0) {
+            record = &records[i];
+            break;
+        }
+    }
+
+    if (!record || !record_is_fresh(record)) {
+        CacheRecord fresh;
+        if (!resolve_record(package, &fresh))
+            return -1;
+
+        if (!record) {
+            if (record_count < PACKAGE_CACHE_SIZE) {
+                record = &records[record_count++];
+            } else {
+                // Evict least recently used package
+                record = &records[0];
+                for (size_t i = 1; i < record_count; i++) {
+                    if (records[i].last_used < record->last_used)
+                        record = &records[i];
+                }
+            }
+        }
+
+        *record = fresh;
+        record->last_used = time(NULL);
+        package_cache_save();
+        log_nusantara(LOG_DEBUG, "Cached metadata of %s (UID %d, ABI %s)", package, record->uid,
+                      record->abi[0] ? record->abi : "none");
+    } else {
+        record->last_used = time(NULL);
+    }
+
+    snprintf(info->apk_dir, sizeof(info->apk_dir), "%s", record->apk_dir);
+    snprintf(info->abi, sizeof(info->abi), "%s", record->abi);
+    info->uid = record->uid;
+    if (record->abi[0])
+        snprintf(info->lib_dir, sizeof(info->lib_dir), "%s/lib/%s", record->apk_dir, record->abi);
+    else
+        info->lib_dir[0] = '\0';
+
+    return 0;
+}
@@ -32,17 +32,11 @@ void NusantaraPreload(const char* package) {
     /*  DYNAMIC RAM INFO  */
     long mem_total_mb = 0;
     long mem_avail_mb = 0;
-    FILE* meminfo = fopen("/proc/meminfo", "r");
-    if (meminfo) {
-        char line[256];
-        long v;
-        while (fgets(line, sizeof(line), meminfo)) {
-            if (sscanf(line, "MemTotal: %ld kB", &v) == 1)
-                mem_total_mb = v / 1024;
-            else if (sscanf(line, "MemAvailable: %ld kB", &v) == 1)
-                mem_avail_mb = v / 1024;
-        }
-        fclose(meminfo);
+    MemInfo meminfo;
+    if (parse_meminfo(&meminfo) == PARSE_OK) {
+        mem_total_mb = meminfo.total_kb / 1024;
+        if (meminfo.available_kb > 0)
+            mem_avail_mb = meminfo.available_kb / 1024;
     }
     
     if (mem_total_mb < 4000) {
@@ -82,53 +76,19 @@ void NusantaraPreload(const char* package) {
         "NusantaraPreload | Budget %s | Avail %ldMB",
         budget, mem_avail_mb);
 
-    /*  GET APK PATH  */
-    char apk_path[256] = {0};
-    char cmd_apk[512];
-    snprintf(cmd_apk, sizeof(cmd_apk),
-             "cmd package path %s | head -n1 | cut -d: -f2",
-             package);
-
-    FILE* apk = popen(cmd_apk, "r");
-    if (!apk || !fgets(apk_path, sizeof(apk_path), apk)) {
+    /*  PACKAGE METADATA  */
+    PackageInfo info;
+    if (package_cache_lookup(package, &info) != 0) {
         log_nusantara(LOG_WARN,
             "Failed to get APK path for %s", package);
-        if (apk) pclose(apk);
-        return;
-    }
-    pclose(apk);
-    apk_path[strcspn(apk_path, "\n")] = 0;
-
-    /*  EXTRACT APK DIR  */
-    char* last_slash = strrchr(apk_path, '/');
-    if (!last_slash) {
-        log_nusantara(LOG_WARN,
-            "Invalid APK path: %s", apk_path);
         return;
     }
-    *last_slash = '\0';
-
-    /*  ABI LIB DETECTION (ARM64 ONLY)  */
-    char lib_path[300] = {0};
-    bool lib_exists = false;
-    snprintf(lib_path, sizeof(lib_path),
-             "%s/lib/arm64", apk_path);
-
-    DIR* d = opendir(lib_path);
-    if (d) {
-        struct dirent* e;
-        while ((e = readdir(d))) {
-            if (strstr(e->d_name, ".so")) {
-                lib_exists = true;
-                break;
-            }
-        }
-        closedir(d);
-    }
+    const char* apk_path = info.apk_dir;
+    const char* lib_path = info.lib_dir;
+    bool lib_exists = info.lib_dir[0] != '\0';
 
     /*  EXECUTE PRELOAD  */
-    FILE* fp = NULL;
-    char line[1024];
+    CommandResult preload;
     int total_pages = 0;
     char last_size[32] = {0};
     char preload_cmd[512];
@@ -147,16 +107,17 @@ void NusantaraPreload(const char* package) {
             "Preloading split APKs: %s", apk_path);
     }
 
-    fp = popen(preload_cmd, "r");
-    if (!fp) {
+    run_shell(preload_cmd, PRELOAD_TIMEOUT_MS, &preload);
+    if (!preload.output) {
         log_nusantara(LOG_WARN,
             "Failed to execute preloader for %s", package);
         return;
     }
 
     /*  PARSE OUTPUT  */
-    while (fgets(line, sizeof(line), fp)) {
-        line[strcspn(line, "\n")] = 0;
+    char* saveptr;
+    for (char* line = strtok_r(preload.output, "\n", &saveptr); line;
+         line = strtok_r(NULL, "\n", &saveptr)) {
         char* p = strstr(line, "Touched Pages:");
         if (p) {
             int pages = 0;
@@ -180,7 +141,7 @@ void NusantaraPreload(const char* package) {
         }
     }
 
-    pclose(fp);
+    free_command_result(&preload);
 
     /*  FINAL LOG  */
     log_nusantara(LOG_INFO,
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/filter.h>
+#include <linux/netlink.h>
+#include <stddef.h>
+#include <sys/socket.h>
+
+// Offsets of proc_event fields inside a received netlink datagram
+#define PROC_EVENT_OFFSET (NLMSG_LENGTH(0) + sizeof(struct cn_msg))
+#define PROC_EVENT_WHAT (PROC_EVENT_OFFSET + offsetof(struct proc_event, what))
+#define PROC_EVENT_PID (PROC_EVENT_OFFSET + offsetof(struct proc_event, event_data.exec.process_pid))
+#define PROC_EVENT_TGID (PROC_EVENT_OFFSET + offsetof(struct proc_event, event_data.exec.process_tgid))
+
+/***********************************************************************************
+ * Function Name      : attach_event_filter
+ * Inputs             : fd (int) - process connector socket
+ * Returns            : None
+ * Description        : Attach classic BPF filter so kernel only delivers exec, comm
+ *                      and exit events of thread group leaders. Fork and per-thread
+ *                      events are dropped before they can wake us up.
+ * Note               : BPF_ABS loads are big endian, hence htonl() on constants.
+ ***********************************************************************************/
+static void attach_event_filter(int fd) {
+    struct sock_filter code[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, PROC_EVENT_WHAT),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(PROC_EVENT_EXEC), 3, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(PROC_EVENT_COMM), 2, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, htonl(PROC_EVENT_EXIT), 1, 0),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, PROC_EVENT_PID),
+        BPF_STMT(BPF_MISC | BPF_TAX, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, PROC_EVENT_TGID),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_X, 0, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xffffffff),
+        BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+
+    struct sock_fprog prog = {.len = sizeof(code) / sizeof(code[0]), .filter = code};
+    if (setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) == -1) {
+        log_nusantara(LOG_DEBUG, "Unable to attach process event filter: %s", strerror(errno));
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : proc_monitor_init
+ * Inputs             : None
+ * Returns            : int - netlink socket fd on success
+ *                           -1 if process connector is unavailable
+ * Description        : Subscribe to kernel process connector to get notified when
+ *                      a process gets executed, renamed or exited.
+ * Note               : Requires CONFIG_PROC_EVENTS, daemon keeps polling without it.
+ ***********************************************************************************/
+int proc_monitor_init(void) {
+    int fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+    if (fd == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "Process connector unavailable: %s", strerror(errno));
+        return -1;
+    }
+
+    struct sockaddr_nl addr = {.nl_family = AF_NETLINK, .nl_groups = CN_IDX_PROC};
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "Unable to bind process connector: %s", strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    attach_event_filter(fd);
+
+    // Build PROC_CN_MCAST_LISTEN request
+    char buf[NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op))] __attribute__((aligned(NLMSG_ALIGNTO))) = {0};
+    struct nlmsghdr* nlh = (struct nlmsghdr*)buf;
+    struct cn_msg* msg = NLMSG_DATA(nlh);
+    enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(op));
+    nlh->nlmsg_type = NLMSG_DONE;
+    nlh->nlmsg_pid = getpid();
+    msg->id.idx = CN_IDX_PROC;
+    msg->id.val = CN_VAL_PROC;
+    msg->len = sizeof(op);
+    memcpy(msg->data, &op, sizeof(op));
+
+    if (send(fd, nlh, nlh->nlmsg_len, 0) == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "Unable to subscribe process events: %s", strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    log_nusantara(LOG_INFO, "Event-driven game detection enabled");
+    return fd;
+}
+
+/***********************************************************************************
+ * Function Name      : is_game_process
+ * Inputs             : pid (pid_t) - PID of new process
+ * Returns            : bool - true if process belongs to a package in gamelist
+ * Description        : Resolve process name and match it against gamelist.
+ *                      Secondary processes (package:service) are matched by package.
+ ***********************************************************************************/
+static bool is_game_process(pid_t pid) {
+    char name[MAX_PACKAGE];
+    if (get_process_name(pid, name, sizeof(name)) != 0)
+        return false;
+
+    char* colon = strchr(name, ':');
+    if (colon)
+        *colon = '\0';
+
+    if (!gamelist_contains(name))
+        return false;
+
+    log_nusantara(LOG_DEBUG, "Game process %s spawned as PID %d", name, pid);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : proc_monitor_handle
+ * Inputs             : fd (int) - process connector socket
+ * Returns            : bool - true if main loop should re-evaluate now
+ * Description        : Drain pending process events. Wakes the main loop when a
+ *                      game process shows up with screen on or the tracked game
+ *                      exits.
+ ***********************************************************************************/
+bool proc_monitor_handle(int fd) {
+    char buf[4096] __attribute__((aligned(NLMSG_ALIGNTO)));
+    bool wake = false;
+
+    while (1) {
+        int len = (int)recv(fd, buf, sizeof(buf), 0);
+        if (len == -1) {
+            // We lost some events, let main loop recheck just in case
+            if (errno == ENOBUFS) {
+                wake = true;
+                continue;
+            }
+            break;
+        }
+
+        for (struct nlmsghdr* nlh = (struct nlmsghdr*)buf; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+            if (nlh->nlmsg_type == NLMSG_NOOP || nlh->nlmsg_type == NLMSG_ERROR)
+                continue;
+
+            struct cn_msg* msg = NLMSG_DATA(nlh);
+            if (msg->id.idx != CN_IDX_PROC || msg->id.val != CN_VAL_PROC)
+                continue;
+
+            struct proc_event* ev = (struct proc_event*)msg->data;
+            switch (ev->what) {
+            // Android apps are forked from zygote and never exec, but they
+            // rename themselves to package name which emits comm event.
+            case PROC_EVENT_EXEC:
+            case PROC_EVENT_COMM:
+                if (!gamestart && !scheduler_suspended() && is_game_process(ev->event_data.exec.process_pid))
+                    wake = true;
+                break;
+            case PROC_EVENT_EXIT:
+                if (game_pid != 0 && ev->event_data.exit.process_pid == game_pid) {
+                    game_exit_pending = true;
+                    wake = true;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    return wake;
+}
@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <proc_parse.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <unistd.h>
+
+/***********************************************************************************
+ * Function Name      : skip_blank
+ * Inputs             : p (const char *) - position in text
+ * Returns            : const char * - first non blank character
+ * Description        : Skip spaces and tabs, newlines are kept as field delimiters.
+ ***********************************************************************************/
+static const char* skip_blank(const char* p) {
+    while (*p == ' ' || *p == '\t')
+        p++;
+    return p;
+}
+
+/***********************************************************************************
+ * Function Name      : scan_ull
+ * Inputs             : cursor (const char **) - position in text, advanced on success
+ *                      value (unsigned long long *) - receives parsed number
+ * Returns            : int - PARSE_OK, PARSE_ERR_FORMAT or PARSE_ERR_RANGE
+ * Description        : Parse an unsigned decimal number.
+ ***********************************************************************************/
+static int scan_ull(const char** cursor, unsigned long long* value) {
+    const char* p = skip_blank(*cursor);
+    if (*p < '0' || *p > '9')
+        return PARSE_ERR_FORMAT;
+
+    unsigned long long result = 0;
+    for (; *p >= '0' && *p <= '9'; p++) {
+        unsigned digit = *p - '0';
+        if (result > (ULLONG_MAX - digit) / 10)
+            return PARSE_ERR_RANGE;
+        result = result * 10 + digit;
+    }
+
+    *value = result;
+    *cursor = p;
+    return PARSE_OK;
+}
+
+/***********************************************************************************
+ * Function Name      : scan_long
+ * Inputs             : cursor (const char **) - position in text, advanced on success
+ *                      value (long *) - receives parsed number
+ * Returns            : int - PARSE_OK, PARSE_ERR_FORMAT or PARSE_ERR_RANGE
+ * Description        : Parse a signed decimal number after optional blanks.
+ * Note               : Cursor and value are left untouched on error.
+ ***********************************************************************************/
+int scan_long(const char** cursor, long* value) {
+    const char* p = skip_blank(*cursor);
+    bool negative = (*p == '-');
+    if (*p == '-' || *p == '+')
+        p++;
+
+    unsigned long long magnitude;
+    int status = scan_ull(&p, &magnitude);
+    if (status != PARSE_OK)
+        return status;
+
+    if (magnitude > (unsigned long long)LONG_MAX + negative)
+        return PARSE_ERR_RANGE;
+
+    *value = negative ? (long)(0 - magnitude) : (long)magnitude;
+    *cursor = p;
+    return PARSE_OK;
+}
+
+/***********************************************************************************
+ * Function Name      : scan_hundredths
+ * Inputs             : cursor (const char **) - position in text, advanced on success
+ *                      value (int *) - receives number scaled by 100
+ * Returns            : int - PARSE_OK or PARSE_ERR_FORMAT
+ * Description        : Parse a "12.34" style decimal without floating point.
+ ***********************************************************************************/
+static int scan_hundredths(const char** cursor, int* value) {
+    const char* p = *cursor;
+    long whole;
+    if (scan_long(&p, &whole) != PARSE_OK || whole < 0 || whole > INT_MAX / 100)
+        return PARSE_ERR_FORMAT;
+
+    int fraction = 0;
+    if (*p == '.') {
+        p++;
+        for (int scale = 10; *p >= '0' && *p <= '9'; p++, scale /= 10)
+            fraction += (*p - '0') * scale;
+    }
+
+    *value = (int)whole * 100 + fraction;
+    *cursor = p;
+    return PARSE_OK;
+}
+
+/***********************************************************************************
+ * Function Name      : scan_field
+ * Inputs             : text (const char *) - "Key: value" formatted text
+ *                      key (const char *) - key to look for, including ':'
+ *                      value (long *) - receives first number after key
+ * Returns            : int - PARSE_OK, PARSE_ERR_MISSING or a scanner error
+ * Description        : Find a line starting with key and parse its value, as used
+ *                      by /proc/<pid>/status and /proc/meminfo.
+ ***********************************************************************************/
+int scan_field(const char* text, const char* key, long* value) {
+    size_t key_len = strlen(key);
+
+    for (const char* line = text; *line;) {
+        if (strncmp(line, key, key_len) == 0) {
+            const char* p = line + key_len;
+            return scan_long(&p, value);
+        }
+
+        const char* next = strchr(line, '\n');
+        if (!next)
+            break;
+        line = next + 1;
+    }
+
+    return PARSE_ERR_MISSING;
+}
+
+/***********************************************************************************
+ * Function Name      : read_node_buffer
+ * Inputs             : path (const char *) - procfs or sysfs node
+ *                      buf (char *) - output buffer
+ *                      size (size_t) - size of output buffer
+ * Returns            : ssize_t - bytes read, PARSE_ERR_IO on error
+ * Description        : Read a node with a single read() and null terminate it.
+ * Note               : procfs and sysfs generate a whole page per read, larger files
+ *                      are truncated to buffer size.
+ ***********************************************************************************/
+ssize_t read_node_buffer(const char* path, char* buf, size_t size) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return PARSE_ERR_IO;
+
+    ssize_t len;
+    do {
+        len = read(fd, buf, size - 1);
+    } while (len == -1 && errno == EINTR);
+    close(fd);
+
+    if (len < 0)
+        return PARSE_ERR_IO;
+
+    buf[len] = '\0';
+    return len;
+}
+
+/***********************************************************************************
+ * Function Name      : read_node_long
+ * Inputs             : path (const char *) - node holding a single number
+ *                      value (long *) - receives parsed number
+ * Returns            : int - PARSE_OK or error code, value is untouched on error
+ * Description        : Read a number from a procfs, sysfs or config node.
+ ***********************************************************************************/
+int read_node_long(const char* path, long* value) {
+    char buf[64];
+    if (read_node_buffer(path, buf, sizeof(buf)) < 0)
+        return PARSE_ERR_IO;
+
+    const char* p = buf;
+    return scan_long(&p, value);
+}
+
+/***********************************************************************************
+ * Function Name      : read_node_string
+ * Inputs             : path (const char *) - node to read
+ *                      buf (char *) - output buffer
+ *                      size (size_t) - size of output buffer
+ * Returns            : int - PARSE_OK or PARSE_ERR_IO, buf is empty on error
+ * Description        : Read first line of a node without its newline.
+ ***********************************************************************************/
+int read_node_string(const char* path, char* buf, size_t size) {
+    if (read_node_buffer(path, buf, size) < 0) {
+        buf[0] = '\0';
+        return PARSE_ERR_IO;
+    }
+
+    buf[strcspn(buf, "\n")] = '\0';
+    return PARSE_OK;
+}
+
+/***********************************************************************************
+ * Function Name      : read_node_list
+ * Inputs             : path (const char *) - node with whitespace separated numbers,
+ *                                            e.g. scaling_available_frequencies
+ *                      values (long *) - output array
+ *                      max (size_t) - capacity of output array
+ *                      count (size_t *) - receives number of parsed values
+ * Returns            : int - PARSE_OK, PARSE_ERR_TRUNCATED if list didn't fit
+ *                           or error code
+ * Description        : Parse a list of numbers from a single node read.
+ * Note               : On error, count still tells how many leading values
+ *                      were parsed.
+ ***********************************************************************************/
+int read_node_list(const char* path, long* values, size_t max, size_t* count) {
+    char buf[PARSE_BUFFER_SIZE];
+    *count = 0;
+
+    if (read_node_buffer(path, buf, sizeof(buf)) < 0)
+        return PARSE_ERR_IO;
+
+    const char* p = buf;
+    while (1) {
+        while (*p == ' ' || *p == '\t' || *p == '\n')
+            p++;
+        if (!*p)
+            break;
+
+        if (*count == max)
+            return PARSE_ERR_TRUNCATED;
+
+        int status = scan_long(&p, &values[*count]);
+        if (status != PARSE_OK)
+            return status;
+        (*count)++;
+    }
+
+    return *count ? PARSE_OK : PARSE_ERR_FORMAT;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_proc_stat
+ * Inputs             : path (const char *) - path of /proc/<pid>/stat
+ *                      stat (ProcStat *) - receives parsed fields
+ * Returns            : int - PARSE_OK or error code
+ * Description        : Parse /proc/<pid>/stat. comm may contain spaces and
+ *                      parentheses, so fields are located from the last ')'.
+ ***********************************************************************************/
+int parse_proc_stat(const char* path, ProcStat* stat) {
+    char buf[1024];
+    if (read_node_buffer(path, buf, sizeof(buf)) < 0)
+        return PARSE_ERR_IO;
+
+    const char* p = buf;
+    long pid;
+    if (scan_long(&p, &pid) != PARSE_OK)
+        return PARSE_ERR_FORMAT;
+
+    const char* open = strchr(p, '(');
+    const char* close = strrchr(p, ')');
+    if (!open || !close || close < open || close[1] != ' ')
+        return PARSE_ERR_FORMAT;
+
+    size_t comm_len = close - open - 1;
+    if (comm_len >= sizeof(stat->comm))
+        comm_len = sizeof(stat->comm) - 1;
+    memcpy(stat->comm, open + 1, comm_len);
+    stat->comm[comm_len] = '\0';
+
+    stat->pid = (pid_t)pid;
+    stat->state = close[2];
+    p = close + 3;
+
+    // Fields 4 onwards, numbered as in proc(5)
+    for (int index = 4; index <= 22; index++) {
+        // Only tpgid, priority and nice can be negative, none of them are kept
+        p = skip_blank(p);
+        if (*p == '-')
+            p++;
+
+        unsigned long long field;
+        if (scan_ull(&p, &field) != PARSE_OK)
+            return PARSE_ERR_FORMAT;
+
+        switch (index) {
+        case 4:
+            stat->ppid = (pid_t)field;
+            break;
+        case 14:
+            stat->utime = field;
+            break;
+        case 15:
+            stat->stime = field;
+            break;
+        case 20:
+            stat->num_threads = (long)field;
+            break;
+        case 22:
+            stat->starttime = field;
+            break;
+        }
+    }
+
+    return PARSE_OK;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_proc_status
+ * Inputs             : path (const char *) - path of /proc/<pid>/status
+ *                      key (const char *) - field name including ':', e.g. "Uid:"
+ *                      value (long *) - receives first number of the field
+ * Returns            : int - PARSE_OK or error code
+ * Description        : Fetch a numeric field of /proc/<pid>/status.
+ ***********************************************************************************/
+int parse_proc_status(const char* path, const char* key, long* value) {
+    char buf[PARSE_BUFFER_SIZE];
+    if (read_node_buffer(path, buf, sizeof(buf)) < 0)
+        return PARSE_ERR_IO;
+
+    return scan_field(buf, key, value);
+}
+
+/***********************************************************************************
+ * Function Name      : parse_proc_cmdline
+ * Inputs             : path (const char *) - path of /proc/<pid>/cmdline
+ *                      name (char *) - receives first argument
+ *                      size (size_t) - size of name buffer
+ * Returns            : int - PARSE_OK, PARSE_ERR_IO or PARSE_ERR_MISSING for
+ *                           kernel threads and zombies
+ * Description        : Fetch process name as set by the process itself, which is
+ *                      the package name for Android apps.
+ ***********************************************************************************/
+int parse_proc_cmdline(const char* path, char* name, size_t size) {
+    ssize_t len = read_node_buffer(path, name, size);
+    if (len < 0)
+        return PARSE_ERR_IO;
+
+    return name[0] ? PARSE_OK : PARSE_ERR_MISSING;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_meminfo
+ * Inputs             : info (MemInfo *) - receives memory counters in kB
+ * Returns            : int - PARSE_OK or error code
+ * Description        : Parse the counters we care about from one /proc/meminfo read.
+ * Note               : MemAvailable is missing on very old kernels, it's left as -1.
+ ***********************************************************************************/
+int parse_meminfo(MemInfo* info) {
+    char buf[PARSE_BUFFER_SIZE];
+    if (read_node_buffer("/proc/meminfo", buf, sizeof(buf)) < 0)
+        return PARSE_ERR_IO;
+
+    info->available_kb = -1;
+    int status = scan_field(buf, "MemTotal:", &info->total_kb);
+    if (status != PARSE_OK)
+        return status;
+
+    if (scan_field(buf, "MemFree:", &info->free_kb) != PARSE_OK)
+        info->free_kb = 0;
+    if (scan_field(buf, "Cached:", &info->cached_kb) != PARSE_OK)
+        info->cached_kb = 0;
+    if (scan_field(buf, "SwapFree:", &info->swap_free_kb) != PARSE_OK)
+        info->swap_free_kb = 0;
+    scan_field(buf, "MemAvailable:", &info->available_kb);
+
+    return PARSE_OK;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_pressure_line
+ * Inputs             : p (const char *) - text after "some" or "full"
+ *                      stat (PressureStat *) - receives parsed averages
+ * Returns            : int - PARSE_OK or PARSE_ERR_FORMAT
+ * Description        : Parse "avg10=0.00 avg60=0.00 avg300=0.00 total=0".
+ ***********************************************************************************/
+static int parse_pressure_line(const char* p, PressureStat* stat) {
+    static const char* keys[] = {" avg10=", " avg60=", " avg300=", " total="};
+    int* averages[] = {&stat->avg10, &stat->avg60, &stat->avg300};
+
+    for (int i = 0; i < 4; i++) {
+        size_t key_len = strlen(keys[i]);
+        if (strncmp(p, keys[i], key_len) != 0)
+            return PARSE_ERR_FORMAT;
+        p += key_len;
+
+        int status = (i < 3) ? scan_hundredths(&p, averages[i]) : scan_ull(&p, &stat->total_us);
+        if (status != PARSE_OK)
+            return PARSE_ERR_FORMAT;
+    }
+
+    return PARSE_OK;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_pressure
+ * Inputs             : path (const char *) - /proc/pressure/{cpu,memory,io}
+ *                      some (PressureStat *) - receives "some" line, may be NULL
+ *                      full (PressureStat *) - receives "full" line, may be NULL
+ * Returns            : int - PARSE_OK, PARSE_ERR_MISSING if a requested line is
+ *                           absent (cpu has no "full" before 5.13) or error code
+ * Description        : Parse pressure stall information of a resource.
+ ***********************************************************************************/
+int parse_pressure(const char* path, PressureStat* some, PressureStat* full) {
+    char buf[256];
+    if (read_node_buffer(path, buf, sizeof(buf)) < 0)
+        return PARSE_ERR_IO;
+
+    bool got_some = false, got_full = false;
+    for (const char* line = buf; *line;) {
+        if (some && strncmp(line, "some", 4) == 0) {
+            if (parse_pressure_line(line + 4, some) != PARSE_OK)
+                return PARSE_ERR_FORMAT;
+            got_some = true;
+        } else if (full && strncmp(line, "full", 4) == 0) {
+            if (parse_pressure_line(line + 4, full) != PARSE_OK)
+                return PARSE_ERR_FORMAT;
+            got_full = true;
+        }
+
+        const char* next = strchr(line, '\n');
+        if (!next)
+            break;
+        line = next + 1;
+    }
+
+    if ((some && !got_some) || (full && !got_full))
+        return PARSE_ERR_MISSING;
+
+    return PARSE_OK;
+}
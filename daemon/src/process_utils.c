@@ -15,81 +15,270 @@
  */
 
 #include <nusantara.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+#define PACKAGES_LIST "/data/system/packages.list"
+#define DENTS_BUFFER_SIZE 32768
+#define UID_CACHE_SIZE 16
+#define PER_USER_RANGE 100000
+#define TASK_COMM_LEN 16
+
+const char* proc_root = DEFAULT_PROC_ROOT;
+
+// Layout of records returned by getdents64
+struct linux_dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+typedef struct {
+    char package[MAX_PACKAGE];
+    int uid;
+} UidCacheEntry;
+
+static UidCacheEntry uid_cache[UID_CACHE_SIZE];
+static size_t uid_cache_next = 0;
+static struct timespec uid_cache_mtime; // packages.list the cache was filled from
 
 /***********************************************************************************
- * Function Name      : pidof
- * Inputs             : name (char *) - Name of process
- * Returns            : pid (pid_t) - PID of process
- * Description        : Fetch PID from a process name.
- * Note               : You can input inexact process name.
+ * Function Name      : package_uid
+ * Inputs             : name (const char *) - process name, "package" or
+ *                      "package:suffix"
+ * Returns            : int - app UID of package, -1 if not an installed package
+ * Description        : Resolve package UID from packages.list, remembering the
+ *                      answer so the file is read once per package. Answers are
+ *                      dropped whenever packages.list changes, an install or
+ *                      reinstall may give a package a new UID.
  ***********************************************************************************/
-pid_t pidof(const char* name) {
-    DIR* proc_dir = opendir("/proc");
-    if (!proc_dir) [[clang::unlikely]] {
-        perror("opendir");
-        return 0;
+int package_uid(const char* name) {
+    char package[MAX_PACKAGE];
+    snprintf(package, sizeof(package), "%.*s", (int)strcspn(name, ":"), name);
+
+    struct stat st;
+    if (stat(PACKAGES_LIST, &st) == 0 && (st.st_mtim.tv_sec != uid_cache_mtime.tv_sec ||
+                                          st.st_mtim.tv_nsec != uid_cache_mtime.tv_nsec)) {
+        memset(uid_cache, 0, sizeof(uid_cache));
+        uid_cache_next = 0;
+        uid_cache_mtime = st.st_mtim;
     }
 
-    pid_t tracked_pid = 0;
-    struct dirent* entry;
-
-    while ((entry = readdir(proc_dir))) {
-        if (entry->d_type != DT_DIR)
-            continue;
-
-        // Check if directory name is a valid PID
-        bool is_pid = true;
-        for (char* p = entry->d_name; *p; ++p) {
-            if (!isdigit((unsigned char)*p)) {
-                is_pid = false;
-                break;
-            }
-        }
+    for (size_t i = 0; i < UID_CACHE_SIZE; i++) {
+        if (uid_cache[i].package[0] && strcmp(uid_cache[i].package, package) == 0)
+            return uid_cache[i].uid;
+    }
+
+    FILE* fp = fopen(PACKAGES_LIST, "r");
+    if (!fp)
+        return -1;
 
-        if (!is_pid) [[clang::unlikely]] {
-            continue;
+    // Format: <package> <uid> <debuggable> <data dir> <seinfo> <gids>
+    int uid = -1;
+    size_t package_len = strlen(package);
+    char line[MAX_DATA_LENGTH];
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, package, package_len) == 0 && line[package_len] == ' ') {
+            uid = atoi(line + package_len + 1);
+            break;
         }
+    }
+    fclose(fp);
+
+    // Negative answers are cached too, name may not be a package at all
+    UidCacheEntry* entry = &uid_cache[uid_cache_next];
+    uid_cache_next = (uid_cache_next + 1) % UID_CACHE_SIZE;
+    snprintf(entry->package, sizeof(entry->package), "%s", package);
+    entry->uid = uid;
+    return uid;
+}
 
-        // Read cmdline
-        char path[256];
-        snprintf(path, sizeof(path), "/proc/%s/cmdline", entry->d_name);
-        FILE* fp = fopen(path, "r");
+/***********************************************************************************
+ * Function Name      : read_proc_node
+ * Inputs             : dir_fd (int) - fd of /proc
+ *                      pid (const char *) - PID directory name
+ *                      node (const char *) - node under PID directory
+ *                      buf (char *) - output buffer
+ *                      size (size_t) - size of output buffer
+ * Returns            : ssize_t - bytes read, -1 on error
+ * Description        : Read a /proc/<pid> node with a single read().
+ ***********************************************************************************/
+static ssize_t read_proc_node(int dir_fd, const char* pid, const char* node, char* buf, size_t size) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/%s", pid, node);
 
-        if (!fp) [[clang::unlikely]] {
-            continue;
-        }
+    int fd = openat(dir_fd, path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return -1;
 
-        char cmdline[4096];
-        size_t len = fread(cmdline, 1, sizeof(cmdline) - 1, fp);
-        fclose(fp);
+    ssize_t len = read(fd, buf, size - 1);
+    close(fd);
 
-        if (len == 0) [[clang::unlikely]] {
-            continue;
-        }
+    if (len < 0)
+        return -1;
 
-        // Replace null bytes with spaces
-        for (size_t i = 0; i < len; ++i) {
-            if (cmdline[i] == '\0')
-                cmdline[i] = ' ';
-        }
-        cmdline[len] = '\0';
+    buf[len] = '\0';
+    return len;
+}
+
+/***********************************************************************************
+ * Function Name      : comm_matches
+ * Inputs             : comm (const char *) - content of /proc/<pid>/comm
+ *                      name (const char *) - process name being looked for
+ * Returns            : bool - true if comm can belong to name
+ * Description        : Zygote names app processes after the first 15 characters,
+ *                      or the last 15 for long dotted names.
+ ***********************************************************************************/
+static bool comm_matches(const char* comm, const char* name) {
+    size_t len = strlen(name);
+    size_t comm_len = strcspn(comm, "\n");
+    size_t max = TASK_COMM_LEN - 1;
+
+    if (len <= max)
+        return comm_len == len && strncmp(comm, name, len) == 0;
+
+    return comm_len == max && (strncmp(comm, name, max) == 0 || strncmp(comm, name + len - max, max) == 0);
+}
+
+/***********************************************************************************
+ * Function Name      : scan_proc
+ * Inputs             : name (const char *) - process name
+ *                      exact (bool) - match whole first cmdline argument
+ *                      uid (int) - app UID to narrow by, -1 to check every process
+ *                      check_comm (bool) - reject by comm before reading cmdline
+ * Returns            : pid_t - lowest matching PID, 0 if not found
+ * Description        : Walk /proc with getdents64, cheapest checks first.
+ ***********************************************************************************/
+static pid_t scan_proc(const char* name, bool exact, int uid, bool check_comm) {
+    int dir_fd = open(proc_root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_ERROR, "Unable to open %s", proc_root);
+        return 0;
+    }
+
+    pid_t tracked_pid = 0;
+    size_t name_len = strlen(name);
+    char buf[DENTS_BUFFER_SIZE] __attribute__((aligned(8)));
+
+    long nread;
+    while ((nread = syscall(SYS_getdents64, dir_fd, buf, sizeof(buf))) > 0) {
+        for (long pos = 0; pos < nread;) {
+            struct linux_dirent64* entry = (struct linux_dirent64*)(buf + pos);
+            pos += entry->d_reclen;
 
-        // Check for substring match
-        if (strstr(cmdline, name) != NULL) {
-            char* end;
-            long pid_val = strtol(entry->d_name, &end, 10);
-            if (end == entry->d_name || *end != '\0' || pid_val <= 0)
+            if (entry->d_type != DT_DIR || !isdigit((unsigned char)entry->d_name[0]))
                 continue;
 
-            if (tracked_pid == 0 || pid_val < tracked_pid)
-                tracked_pid = (pid_t)pid_val;
+            pid_t pid = (pid_t)atoi(entry->d_name);
+            if (pid <= 0 || (tracked_pid != 0 && pid >= tracked_pid))
+                continue;
+
+            // App processes run as their package UID, per user
+            if (uid != -1) {
+                struct stat st;
+                if (fstatat(dir_fd, entry->d_name, &st, 0) == -1 || (int)(st.st_uid % PER_USER_RANGE) != uid % PER_USER_RANGE)
+                    continue;
+            }
+
+            char comm[TASK_COMM_LEN + 1];
+            if (check_comm && (read_proc_node(dir_fd, entry->d_name, "comm", comm, sizeof(comm)) <= 0 || !comm_matches(comm, name)))
+                continue;
+
+            // Exact match only needs name and its terminator
+            char cmdline[MAX_DATA_LENGTH];
+            size_t want = (exact && name_len + 2 < sizeof(cmdline)) ? name_len + 2 : sizeof(cmdline);
+            ssize_t len = read_proc_node(dir_fd, entry->d_name, "cmdline", cmdline, want);
+            if (len <= 0) [[clang::unlikely]]
+                continue;
+
+            bool matched;
+            if (exact) {
+                // First argument must be name itself, nothing more
+                matched = strncmp(cmdline, name, name_len) == 0 && cmdline[name_len] == '\0';
+            } else {
+                for (ssize_t i = 0; i < len; i++) {
+                    if (cmdline[i] == '\0')
+                        cmdline[i] = ' ';
+                }
+                matched = strstr(cmdline, name) != NULL;
+            }
+
+            if (matched)
+                tracked_pid = pid;
         }
     }
 
-    closedir(proc_dir);
+    close(dir_fd);
     return tracked_pid;
 }
 
+/***********************************************************************************
+ * Function Name      : pidof
+ * Inputs             : name (char *) - Name of process
+ * Returns            : pid (pid_t) - PID of process
+ * Description        : Fetch PID from a process name.
+ * Note               : You can input inexact process name.
+ ***********************************************************************************/
+pid_t pidof(const char* name) {
+    return scan_proc(name, false, package_uid(name), false);
+}
+
+/***********************************************************************************
+ * Function Name      : pidof_exact
+ * Inputs             : name (char *) - exact process name, e.g. "package:suffix"
+ * Returns            : pid (pid_t) - lowest PID of process, 0 if not found
+ * Description        : Fetch PID of a process whose name is exactly name. Only
+ *                      processes owned by the package UID are considered, and
+ *                      comm is checked before cmdline gets read.
+ * Note               : For packages, falls back to a scan without comm check in
+ *                      case app renamed its main thread. UID keeps that one cheap.
+ ***********************************************************************************/
+pid_t pidof_exact(const char* name) {
+    int uid = package_uid(name);
+
+    pid_t pid = scan_proc(name, true, uid, true);
+    if (pid == 0 && uid != -1)
+        pid = scan_proc(name, true, uid, false);
+
+    return pid;
+}
+
+/***********************************************************************************
+ * Function Name      : get_process_name
+ * Inputs             : pid (pid_t) - PID of process
+ *                      name (char *) - buffer to store process name
+ *                      size (size_t) - size of buffer
+ * Returns            : int - 0 on success
+ *                           -1 on error or empty cmdline
+ * Description        : Fetch first argument of /proc/<pid>/cmdline, which is the
+ *                      package name for Android app processes.
+ ***********************************************************************************/
+int get_process_name(pid_t pid, char* name, size_t size) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/%d/cmdline", proc_root, (int)pid);
+    return parse_proc_cmdline(path, name, size) == PARSE_OK ? 0 : -1;
+}
+
+/***********************************************************************************
+ * Function Name      : process_alive
+ * Inputs             : pid (pid_t) - PID of process
+ * Returns            : bool - true if process is running
+ * Description        : Unlike kill(pid, 0), treats a zombie waiting to be reaped
+ *                      as already gone.
+ ***********************************************************************************/
+bool process_alive(pid_t pid) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/%d/stat", proc_root, (int)pid);
+
+    ProcStat stat;
+    if (parse_proc_stat(path, &stat) != PARSE_OK)
+        return false;
+
+    return stat.state != 'Z' && stat.state != 'X';
+}
+
 /***********************************************************************************
  * Function Name      : uidof
  * Inputs             : pid (pid_t) - PID of process
@@ -99,26 +288,16 @@ pid_t pidof(const char* name) {
  ***********************************************************************************/
 int uidof(pid_t pid) {
     char path[MAX_PATH_LENGTH];
-    char line[MAX_DATA_LENGTH];
-    FILE* status_file;
-    int uid = -1;
+    snprintf(path, sizeof(path), "%s/%d/status", proc_root, (int)pid);
 
-    snprintf(path, sizeof(path), "/proc/%d/status", (int)pid);
-    status_file = fopen(path, "r");
-    if (!status_file) {
-        perror("fopen");
+    long uid;
+    int status = parse_proc_status(path, "Uid:", &uid);
+    if (status != PARSE_OK) {
+        log_nusantara(LOG_WARN, "Unable to read UID of %d (%d)", (int)pid, status);
         return -1;
     }
 
-    while (fgets(line, sizeof(line), status_file) != NULL) {
-        if (strncmp(line, "Uid:", 4) == 0) {
-            sscanf(line + 4, "%d", &uid);
-            break;
-        }
-    }
-
-    fclose(status_file);
-    return uid;
+    return (int)uid;
 }
 
 /***********************************************************************************
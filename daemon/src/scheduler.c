@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <limits.h>
+
+#define REPORT_PERIOD_MS (60 * 60 * 1000)
+
+static int min_interval = POLL_INTERVAL_MIN;
+static int max_interval = POLL_INTERVAL_MAX;
+static int interval = POLL_INTERVAL_MIN;
+static int burst_left = POLL_BURST_TICKS;
+static bool suspended = false;
+static bool screen_events = false;
+
+static unsigned int ticks = 0;
+static long long period_start = 0;
+
+/***********************************************************************************
+ * Function Name      : read_interval
+ * Inputs             : path (const char *) - config file holding interval in ms
+ *                      fallback (int) - value used when file is missing or invalid
+ * Returns            : int - interval in milliseconds
+ * Description        : Read a polling interval from module config.
+ ***********************************************************************************/
+static int read_interval(const char* path, int fallback) {
+    long value;
+    if (read_node_long(path, &value) != PARSE_OK || value < 100 || value > INT_MAX)
+        return fallback;
+
+    return (int)value;
+}
+
+/***********************************************************************************
+ * Function Name      : now_ms
+ * Inputs             : None
+ * Returns            : long long - monotonic clock in milliseconds
+ * Description        : Clock used to compute wakeup statistics.
+ ***********************************************************************************/
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : scheduler_init
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Load polling bounds from config, starting in fast poll window.
+ ***********************************************************************************/
+void scheduler_init(void) {
+    min_interval = read_interval(POLL_MIN_CONFIG, POLL_INTERVAL_MIN);
+    max_interval = read_interval(POLL_MAX_CONFIG, POLL_INTERVAL_MAX);
+    if (max_interval < min_interval)
+        max_interval = min_interval;
+
+    interval = min_interval;
+    burst_left = POLL_BURST_TICKS;
+    period_start = now_ms();
+
+    log_nusantara(LOG_INFO, "Adaptive polling between %dms and %dms", min_interval, max_interval);
+}
+
+/***********************************************************************************
+ * Function Name      : scheduler_poke
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Report a state change (event wakeup, app switch, profile
+ *                      switch), polls quickly for a short window afterwards.
+ ***********************************************************************************/
+void scheduler_poke(void) {
+    burst_left = POLL_BURST_TICKS;
+    interval = min_interval;
+}
+
+/***********************************************************************************
+ * Function Name      : scheduler_set_screen
+ * Inputs             : screen_on (bool) - current screen state
+ *                      events (bool) - screen changes wake the event loop
+ * Returns            : None
+ * Description        : Suspend detection while screen is off, polling quickly
+ *                      again once it turns back on.
+ ***********************************************************************************/
+void scheduler_set_screen(bool screen_on, bool events) {
+    screen_events = events;
+    if (suspended == !screen_on)
+        return;
+
+    suspended = !screen_on;
+    if (screen_on)
+        scheduler_poke();
+}
+
+/***********************************************************************************
+ * Function Name      : scheduler_suspended
+ * Inputs             : None
+ * Returns            : bool - true while screen is off
+ * Description        : Lets event sources drop wakeups nothing would act on.
+ ***********************************************************************************/
+bool scheduler_suspended(void) {
+    return suspended;
+}
+
+/***********************************************************************************
+ * Function Name      : report_savings
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Periodically log wakeups compared to fixed interval polling.
+ ***********************************************************************************/
+static void report_savings(void) {
+    long long now = now_ms();
+    long long elapsed = now - period_start;
+    if (elapsed < REPORT_PERIOD_MS)
+        return;
+
+    long long fixed_ticks = elapsed / (LOOP_INTERVAL * 1000);
+    log_nusantara(LOG_INFO, "Scheduler: %u wakeups in %lld min, %lld saved vs fixed %ds polling", ticks, elapsed / 60000,
+                  fixed_ticks - ticks, LOOP_INTERVAL);
+
+    ticks = 0;
+    period_start = now;
+}
+
+/***********************************************************************************
+ * Function Name      : scheduler_next_interval
+ * Inputs             : None
+ * Returns            : int - time in milliseconds to wait before next tick,
+ *                            -1 to wait for events only
+ * Description        : Fast interval during burst window, then back off
+ *                      exponentially toward ceiling while state is stable.
+ *                      With screen off there is nothing to detect, only events
+ *                      wake us unless screen-on can't be seen as one.
+ ***********************************************************************************/
+int scheduler_next_interval(void) {
+    ticks++;
+    report_savings();
+
+    if (suspended) {
+        interval = max_interval;
+        if (screen_events)
+            return -1;
+    } else if (burst_left > 0) {
+        burst_left--;
+        interval = min_interval;
+    } else {
+        interval = (interval > max_interval / 2) ? max_interval : interval * 2;
+    }
+
+    return interval;
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+
+#define DRM_CLASS "/sys/class/drm"
+#define BACKLIGHT_CLASS "/sys/class/backlight"
+#define LCD_BACKLIGHT_LED "/sys/class/leds/lcd-backlight/brightness"
+
+// Recheck a native node against dumpsys when it hasn't changed for this long,
+// sooner while it has never been seen to change
+#define REVALIDATE_MS (30 * 60 * 1000)
+#define UNCONFIRMED_REVALIDATE_MS (5 * 60 * 1000)
+
+typedef enum : char {
+    SCREEN_UNPROBED,
+    SCREEN_DRM_DPMS,
+    SCREEN_BACKLIGHT,
+    SCREEN_DUMPSYS
+} ScreenBackend;
+
+static const char* backend_name[] = {"unprobed", "drm dpms", "backlight", "dumpsys"};
+static ScreenBackend backend = SCREEN_UNPROBED;
+
+// Kept open, sysfs attributes are regenerated on every pread() at offset 0
+static int state_fd = -1;
+static int bl_power_fd = -1;
+
+// One agreement at probe time may be luck, a node stuck at "on" matches
+// dumpsys too until the first screen off
+static bool confirmed = false;
+static int last_state = -1;
+static long long last_checked = 0;
+
+/***********************************************************************************
+ * Function Name      : now_ms
+ * Inputs             : None
+ * Returns            : long long - monotonic clock in milliseconds
+ * Description        : Clock used to schedule revalidation.
+ ***********************************************************************************/
+static long long now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/***********************************************************************************
+ * Function Name      : read_node
+ * Inputs             : fd (int) - opened sysfs attribute
+ *                      buf (char *) - output buffer
+ *                      size (size_t) - size of output buffer
+ * Returns            : ssize_t - bytes read, -1 on error
+ * Description        : Re-read a sysfs attribute with a single syscall.
+ ***********************************************************************************/
+static ssize_t read_node(int fd, char* buf, size_t size) {
+    ssize_t len = pread(fd, buf, size - 1, 0);
+    if (len < 0)
+        return -1;
+
+    buf[len] = '\0';
+    return len;
+}
+
+/***********************************************************************************
+ * Function Name      : read_native_state
+ * Inputs             : None
+ * Returns            : int - 1 if screen is on, 0 if off, -1 on error
+ * Description        : Read screen state from selected kernel source.
+ ***********************************************************************************/
+static int read_native_state(void) {
+    char buf[32];
+
+    if (read_node(state_fd, buf, sizeof(buf)) <= 0) [[clang::unlikely]]
+        return -1;
+
+    if (backend == SCREEN_DRM_DPMS)
+        return strncmp(buf, "On", 2) == 0;
+
+    // FB_BLANK_UNBLANK is 0, anything else means panel is powered down
+    if (bl_power_fd != -1) {
+        char power[16];
+        if (read_node(bl_power_fd, power, sizeof(power)) > 0 && atoi(power) != 0)
+            return 0;
+    }
+
+    return atoi(buf) > 0;
+}
+
+/***********************************************************************************
+ * Function Name      : open_drm_dpms
+ * Inputs             : None
+ * Returns            : int - fd of dpms attribute, -1 if not found
+ * Description        : Find dpms node of first connected DRM connector.
+ ***********************************************************************************/
+static int open_drm_dpms(void) {
+    DIR* dir = opendir(DRM_CLASS);
+    if (!dir)
+        return -1;
+
+    int fd = -1;
+    struct dirent* entry;
+    while (fd == -1 && (entry = readdir(dir))) {
+        // Connectors are named cardN-<type>-M
+        if (strncmp(entry->d_name, "card", 4) != 0 || !strchr(entry->d_name, '-'))
+            continue;
+
+        char path[MAX_PATH_LENGTH];
+        char status[32] = {0};
+        snprintf(path, sizeof(path), "%s/%s/status", DRM_CLASS, entry->d_name);
+        int status_fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (status_fd == -1)
+            continue;
+
+        ssize_t len = read_node(status_fd, status, sizeof(status));
+        close(status_fd);
+        if (len <= 0 || strncmp(status, "connected", 9) != 0)
+            continue;
+
+        snprintf(path, sizeof(path), "%s/%s/dpms", DRM_CLASS, entry->d_name);
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+    }
+
+    closedir(dir);
+    return fd;
+}
+
+/***********************************************************************************
+ * Function Name      : open_backlight
+ * Inputs             : None
+ * Returns            : int - fd of brightness attribute, -1 if not found
+ * Description        : Find panel backlight brightness, also opens bl_power when
+ *                      the driver exposes it.
+ ***********************************************************************************/
+static int open_backlight(void) {
+    DIR* dir = opendir(BACKLIGHT_CLASS);
+    if (dir) {
+        struct dirent* entry;
+        while ((entry = readdir(dir))) {
+            if (entry->d_name[0] == '.')
+                continue;
+
+            char path[MAX_PATH_LENGTH];
+            snprintf(path, sizeof(path), "%s/%s/brightness", BACKLIGHT_CLASS, entry->d_name);
+            int fd = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+                continue;
+
+            snprintf(path, sizeof(path), "%s/%s/bl_power", BACKLIGHT_CLASS, entry->d_name);
+            bl_power_fd = open(path, O_RDONLY | O_CLOEXEC);
+            closedir(dir);
+            return fd;
+        }
+        closedir(dir);
+    }
+
+    // MediaTek exposes panel backlight as LED class device
+    return open(LCD_BACKLIGHT_LED, O_RDONLY | O_CLOEXEC);
+}
+
+/***********************************************************************************
+ * Function Name      : close_native
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Close nodes of the native backend.
+ ***********************************************************************************/
+static void close_native(void) {
+    if (state_fd != -1) {
+        close(state_fd);
+        state_fd = -1;
+    }
+    if (bl_power_fd != -1) {
+        close(bl_power_fd);
+        bl_power_fd = -1;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : probe_screen_backend
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Pick the cheapest kernel source that agrees with dumpsys,
+ *                      log the selected backend and its per-call cost.
+ ***********************************************************************************/
+static void probe_screen_backend(void) {
+    int reference = dumpsys_screen_state();
+
+    const ScreenBackend candidates[] = {SCREEN_DRM_DPMS, SCREEN_BACKLIGHT};
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        backend = candidates[i];
+        state_fd = (backend == SCREEN_DRM_DPMS) ? open_drm_dpms() : open_backlight();
+        if (state_fd == -1)
+            continue;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int state = read_native_state();
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        // Some panels never update these nodes, don't trust one that disagrees
+        if (state != -1 && (reference == -1 || state == reference)) {
+            long long cost_us = (end.tv_sec - start.tv_sec) * 1000000LL + (end.tv_nsec - start.tv_nsec) / 1000;
+            log_nusantara(LOG_INFO, "Screen state backend: %s, %lld us per call, unconfirmed", backend_name[backend],
+                          cost_us);
+            confirmed = false;
+            last_state = state;
+            last_checked = now_ms();
+            return;
+        }
+
+        close_native();
+    }
+
+    backend = SCREEN_DUMPSYS;
+    log_nusantara(LOG_INFO, "Screen state backend: %s", backend_name[backend]);
+}
+
+/***********************************************************************************
+ * Function Name      : validate_native
+ * Inputs             : state (int) - value just read from native backend
+ * Returns            : int - screen state to report
+ * Description        : Compare native backend with dumpsys on the first change it
+ *                      reports and whenever it has been quiet for a while.
+ *                      Drops the node for dumpsys when they disagree.
+ ***********************************************************************************/
+static int validate_native(int state) {
+    long long now = now_ms();
+    bool changed = state != last_state;
+    last_state = state;
+
+    // A confirmed node that keeps changing is alive, no need to ask dumpsys
+    if (changed && confirmed) {
+        last_checked = now;
+        return state;
+    }
+
+    if (!changed && now - last_checked < (confirmed ? REVALIDATE_MS : UNCONFIRMED_REVALIDATE_MS))
+        return state;
+
+    last_checked = now;
+    int reference = dumpsys_screen_state();
+    if (reference == -1)
+        return state;
+
+    if (reference == state) {
+        if (!confirmed)
+            log_nusantara(LOG_INFO, "Screen state backend %s confirmed", backend_name[backend]);
+        confirmed = true;
+        return state;
+    }
+
+    log_nusantara(LOG_WARN, "Screen state backend %s reports %s but dumpsys %s, using dumpsys", backend_name[backend],
+                  state ? "on" : "off", reference ? "on" : "off");
+    close_native();
+    backend = SCREEN_DUMPSYS;
+    return reference;
+}
+
+/***********************************************************************************
+ * Function Name      : read_screen_state
+ * Inputs             : None
+ * Returns            : int - 1 if screen is on, 0 if off, -1 on error
+ * Description        : Read screen state from best available source. Backend is
+ *                      probed on first call.
+ ***********************************************************************************/
+int read_screen_state(void) {
+    if (backend == SCREEN_UNPROBED) [[clang::unlikely]]
+        probe_screen_backend();
+
+    if (backend == SCREEN_DUMPSYS)
+        return dumpsys_screen_state();
+
+    int state = read_native_state();
+    if (state == -1) [[clang::unlikely]] {
+        log_nusantara(LOG_WARN, "Screen state backend %s failed, reprobing", backend_name[backend]);
+        close_native();
+        backend = SCREEN_UNPROBED;
+        return dumpsys_screen_state();
+    }
+
+    return validate_native(state);
+}
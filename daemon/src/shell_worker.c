@@ -0,0 +1,404 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+
+#define WORKER_CHUNK 512
+#define WORKER_MAX_FAILURES 3
+
+static pthread_mutex_t worker_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool worker_enabled = false;
+static pid_t worker_pid = -1;
+static int worker_fd = -1;
+static int start_failures = 0;
+static unsigned int sequence = 0;
+
+/***********************************************************************************
+ * Function Name      : worker_kill
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Tear down worker shell along with anything it spawned.
+ ***********************************************************************************/
+static void worker_kill(void) {
+    if (worker_fd != -1) {
+        close(worker_fd);
+        worker_fd = -1;
+    }
+
+    if (worker_pid > 0) {
+        kill(-worker_pid, SIGKILL);
+        while (waitpid(worker_pid, NULL, 0) == -1 && errno == EINTR)
+            ;
+        worker_pid = -1;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : worker_spawn
+ * Inputs             : None
+ * Returns            : int - 0 on success, -1 on error
+ * Description        : Start /system/bin/sh reading commands from one end of a
+ *                      socketpair and writing their output back into it.
+ * Note               : A socket is used instead of pipes so writes to a dead worker
+ *                      can use MSG_NOSIGNAL rather than ignoring SIGPIPE globally,
+ *                      which would leak into every command we run.
+ ***********************************************************************************/
+static int worker_spawn(void) {
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) == -1) [[clang::unlikely]]
+        return -1;
+
+    char* argv[] = {"sh", NULL};
+    char* env[] = {MY_PATH, NULL};
+    pid_t pid = vfork();
+    if (pid == -1) [[clang::unlikely]] {
+        close(sv[0]);
+        close(sv[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        setpgid(0, 0);
+        int devnull = open("/dev/null", O_WRONLY);
+        dup2(sv[1], STDIN_FILENO);
+        dup2(sv[1], STDOUT_FILENO);
+        if (devnull != -1)
+            dup2(devnull, STDERR_FILENO);
+        execve("/system/bin/sh", argv, env);
+        _exit(127);
+    }
+
+    close(sv[1]);
+    worker_fd = sv[0];
+    worker_pid = pid;
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : worker_alive
+ * Inputs             : None
+ * Returns            : bool - true if worker is running, restarting it if needed
+ * Description        : Reap a dead worker and start a fresh one. Gives up after
+ *                      repeated start failures so callers fall back to spawning.
+ ***********************************************************************************/
+static bool worker_alive(void) {
+    if (worker_pid > 0 && waitpid(worker_pid, NULL, WNOHANG) == 0) [[clang::likely]]
+        return true;
+
+    if (worker_pid > 0) {
+        log_nusantara(LOG_WARN, "Shell worker %d died, restarting", worker_pid);
+        worker_pid = -1;
+        worker_kill();
+    }
+
+    if (worker_spawn() == 0) {
+        start_failures = 0;
+        return true;
+    }
+
+    if (++start_failures >= WORKER_MAX_FAILURES) {
+        log_nusantara(LOG_ERROR, "Unable to start shell worker, spawning commands directly");
+        worker_enabled = false;
+    }
+
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : send_all
+ * Inputs             : data (const char *) - buffer to send
+ *                      length (size_t) - length of buffer
+ * Returns            : int - 0 on success, -1 if worker is gone
+ * Description        : Write a complete command frame to the worker.
+ ***********************************************************************************/
+static int send_all(const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = send(worker_fd, data, length, MSG_NOSIGNAL);
+        if (sent == -1 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return -1;
+
+        data += sent;
+        length -= sent;
+    }
+
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : frame_safe
+ * Inputs             : command (const char *) - shell command line
+ * Returns            : bool - true if command can't run past its frame
+ * Description        : A command spanning lines, reading a here-document or with an
+ *                      unterminated quote or parenthesis would swallow the end
+ *                      marker, so the worker would hang until timeout. Background
+ *                      jobs keep writing into the socket after the marker, mixing
+ *                      their output into the next command. Those are left to
+ *                      sh -c, where output goes to a pipe of their own.
+ ***********************************************************************************/
+static bool frame_safe(const char* command) {
+    char quote = '\0';
+    bool backquote = false;
+    int depth = 0;
+
+    for (const char* p = command; *p; p++) {
+        if (*p == '\n')
+            return false;
+
+        if (quote == '\'') {
+            if (*p == '\'')
+                quote = '\0';
+            continue;
+        }
+
+        if (*p == '\\') {
+            if (!*++p || *p == '\n')
+                return false;
+            continue;
+        }
+
+        if (*p == '`') {
+            backquote = !backquote;
+            continue;
+        }
+
+        if (quote == '"') {
+            if (*p == '"')
+                quote = '\0';
+            continue;
+        }
+
+        switch (*p) {
+        case '\'':
+        case '"':
+            quote = *p;
+            break;
+        case '(':
+            depth++;
+            break;
+        case ')':
+            if (--depth < 0)
+                return false;
+            break;
+        case '<':
+            if (p[1] == '<')
+                return false;
+            break;
+        case '&':
+            // && and fd redirections like 2>&1 don't fork a job
+            if (p[1] == '&') {
+                p++;
+                break;
+            }
+            if (p == command || (p[-1] != '>' && p[-1] != '<'))
+                return false;
+            break;
+        case '#':
+            // Comment runs until the newline closing our subshell
+            if (p == command || strchr(" \t;|()", p[-1]))
+                return quote == '\0' && !backquote && depth == 0;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return quote == '\0' && !backquote && depth == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : shell_worker_start
+ * Inputs             : None
+ * Returns            : int - 0 on success, -1 on error
+ * Description        : Start the long-lived worker shell used by run_shell().
+ * Note               : Must be called after daemon(), the worker is our child.
+ ***********************************************************************************/
+int shell_worker_start(void) {
+    pthread_mutex_lock(&worker_lock);
+    worker_enabled = true;
+    start_failures = 0;
+    bool alive = worker_alive();
+    pthread_mutex_unlock(&worker_lock);
+
+    if (alive)
+        log_nusantara(LOG_INFO, "Shell worker started as PID %d", worker_pid);
+
+    return alive ? 0 : -1;
+}
+
+/***********************************************************************************
+ * Function Name      : shell_worker_stop
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Stop worker shell, run_shell() spawns commands again.
+ ***********************************************************************************/
+void shell_worker_stop(void) {
+    pthread_mutex_lock(&worker_lock);
+    worker_enabled = false;
+    worker_kill();
+    pthread_mutex_unlock(&worker_lock);
+}
+
+/***********************************************************************************
+ * Function Name      : shell_worker_run
+ * Inputs             : command (const char *) - shell command line
+ *                      timeout_ms (int) - deadline for the whole command
+ *                      result (CommandResult *) - receives output, may be NULL
+ *                      status (int *) - receives exit status, -1 on failure or timeout
+ * Returns            : bool - true if command was handled by the worker
+ *                             false if worker is disabled or busy, or command isn't
+ *                             frame_safe(), caller should spawn the command itself
+ * Description        : Run a command inside the worker shell. Each command runs in
+ *                      a subshell, so cd, variables, traps and exit don't outlive
+ *                      it, and is framed by a unique end marker carrying its exit
+ *                      status:
+ *
+ *                          ( <command>
+ *                          ) </dev/null
+ *                          echo "\n<marker> $?"
+ *
+ *                      stderr stays on /dev/null, same as commands spawned by
+ *                      run_shell(), so output doesn't depend on who ran it.
+ *
+ * Note               : Worker is killed and restarted on timeout or when command
+ *                      takes it down (e.g. exit).
+ ***********************************************************************************/
+bool shell_worker_run(const char* command, int timeout_ms, CommandResult* result, int* status) {
+    if (!worker_enabled || !frame_safe(command))
+        return false;
+
+    // Another thread is using the worker, don't serialize behind it
+    if (pthread_mutex_trylock(&worker_lock) != 0)
+        return false;
+
+    if (!worker_enabled || !worker_alive()) {
+        pthread_mutex_unlock(&worker_lock);
+        return false;
+    }
+
+    if (result)
+        *result = (CommandResult){.output = NULL, .length = 0, .status = -1, .timed_out = false};
+    *status = -1;
+
+    char marker[32];
+    int marker_len = snprintf(marker, sizeof(marker), "\n__NUSANTARA_%u__ ", ++sequence);
+
+    size_t frame_size = strlen(command) + 96;
+    char* frame = malloc(frame_size);
+    char* output = malloc(WORKER_CHUNK);
+    if (!frame || !output) [[clang::unlikely]] {
+        free(frame);
+        free(output);
+        pthread_mutex_unlock(&worker_lock);
+        return false;
+    }
+
+    size_t frame_len = snprintf(frame, frame_size, "( %s\n) </dev/null\necho \"%s$?\"\n", command, marker);
+    if (send_all(frame, frame_len) != 0) {
+        // Nothing was executed yet, let caller spawn it
+        free(frame);
+        free(output);
+        worker_kill();
+        pthread_mutex_unlock(&worker_lock);
+        return false;
+    }
+    free(frame);
+
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    size_t capacity = WORKER_CHUNK;
+    size_t length = 0;
+    char* end = NULL;
+    bool timed_out = false;
+
+    while (1) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int remaining = timeout_ms - (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+        struct pollfd pfd = {.fd = worker_fd, .events = POLLIN};
+        int ready = (remaining > 0) ? poll(&pfd, 1, remaining) : 0;
+
+        if (ready == -1 && errno == EINTR)
+            continue;
+
+        if (ready == 0) {
+            timed_out = true;
+            break;
+        }
+
+        if (ready == -1) [[clang::unlikely]]
+            break;
+
+        if (length + 1 >= capacity) {
+            char* grown = realloc(output, capacity * 2);
+            if (!grown) [[clang::unlikely]]
+                break;
+            output = grown;
+            capacity *= 2;
+        }
+
+        ssize_t bytes = recv(worker_fd, output + length, capacity - length - 1, 0);
+        if (bytes == -1 && errno == EINTR)
+            continue;
+
+        if (bytes <= 0)
+            break;
+
+        // Marker may straddle two reads, rescan the tail of previous one
+        size_t scan_from = (length > (size_t)marker_len) ? length - marker_len : 0;
+        length += bytes;
+        output[length] = '\0';
+
+        end = strstr(output + scan_from, marker);
+        if (end && strchr(end + marker_len, '\n'))
+            break;
+        end = NULL;
+    }
+
+    if (end) [[clang::likely]] {
+        *status = atoi(end + marker_len);
+        *end = '\0';
+        length = end - output;
+    } else {
+        if (timed_out)
+            log_nusantara(LOG_WARN, "Shell worker timed out after %dms, restarting", timeout_ms);
+        else
+            log_nusantara(LOG_WARN, "Shell worker exited while running a command, restarting");
+
+        // Output is incomplete, don't hand it over
+        worker_kill();
+        length = 0;
+        output[0] = '\0';
+    }
+
+    pthread_mutex_unlock(&worker_lock);
+
+    if (result) {
+        result->output = output;
+        result->length = length;
+        result->status = *status;
+        result->timed_out = timed_out;
+    } else {
+        free(output);
+    }
+
+    return true;
+}
@@ -185,6 +185,10 @@ make_dir "$MODULE_CONFIG"
 make_node 0 "$MODULE_CONFIG/lite_mode"
 make_node 0 "$MODULE_CONFIG/dnd_gameplay"
 make_node 0 "$MODULE_CONFIG/device_mitigation"
+make_node 1 "$MODULE_CONFIG/normal_baseline"
+make_node 1000 "$MODULE_CONFIG/poll_interval_min"
+make_node 15000 "$MODULE_CONFIG/poll_interval_max"
+make_node 1 "$MODULE_CONFIG/shell_worker"
 [ ! -f "$MODULE_CONFIG/ppm_policies_mediatek" ] && echo 'PWR_THRO|THERMAL' >"$MODULE_CONFIG/ppm_policies_mediatek"
 [ ! -f "$MODULE_CONFIG/gamelist.txt" ] && extract "$ZIPFILE" 'gamelist.txt' "$MODULE_CONFIG"
 
@@ -14,8 +14,26 @@
 # limitations under the License.
 #
 
+MODULE_CONFIG="/data/adb/.config/Nusantara"
+BASELINE="$MODULE_CONFIG/baseline"
+
+# Give tuned knobs their stock values back, the baseline only
+# holds for the boot it was captured in.
+if [ -f "$BASELINE" ] && [ "$(head -n 1 "$BASELINE")" = "$(cat /proc/sys/kernel/random/boot_id)" ]; then
+	# Daemon restores on SIGTERM, let it finish before writing the same knobs
+	pkill sys.nusaservice
+	for _ in 1 2 3 4 5 6 7 8 9 10; do
+		pidof sys.nusaservice >/dev/null || break
+		sleep 0.5
+	done
+	tail -n +2 "$BASELINE" | while read -r knob _ value; do
+		chmod 644 "$knob" 2>/dev/null
+		echo "$value" >"$knob" 2>/dev/null
+	done
+fi
+
 pm uninstall --user 0 velocity.toast
-rm -rf /data/adb/.config/Nusantara
+rm -rf "$MODULE_CONFIG"
 need_gone="sys.nusaservice nusantara_profiler nusantara_utility nusantara_log"
 manager_paths="/data/adb/ap/bin /data/adb/ksu/bin"
 
@@ -0,0 +1,29 @@
+#ifndef KNOB_BASELINE_H
+#define KNOB_BASELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BASELINE_MAX_KNOBS 512
+#define BASELINE_PATH_LEN 128
+#define BASELINE_VALUE_LEN 64
+
+// Stock values, captured right before a knob is first changed in this boot
+void baseline_load(void);
+void baseline_capture(const char* path, const char* value);
+void baseline_begin(int column);
+const char* baseline_value(const char* path);
+bool baseline_is_stock(const char* path);
+void baseline_touch(const char* path);
+void baseline_restore(bool all);
+
+// Journal of the profile switch in progress
+bool journal_pending(void);
+void journal_begin(int mode);
+void journal_commit(void);
+
+// Perfcommon, applied once per boot for a given signature
+bool common_stage_done(uint32_t signature);
+void common_stage_record(uint32_t signature);
+
+#endif // KNOB_BASELINE_H
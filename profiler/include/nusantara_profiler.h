@@ -0,0 +1,82 @@
+#ifndef NUSANTARA_PROFILER_H
+#define NUSANTARA_PROFILER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Modes, same numbering as the nusantara_profiler command line
+#define PROFILER_PERFCOMMON 0
+#define PROFILER_PERFORMANCE 1
+#define PROFILER_NORMAL 2
+#define PROFILER_POWERSAVE 3
+#define PROFILER_LITE 4 // performance with lite_mode, only used by overrides
+
+#define MAX_KNOB_OVERRIDES 32
+
+// Knob write flags
+#define KNOB_LOCK 0x1
+#define KNOB_UNLOCK 0x2
+#define KNOB_ALWAYS 0x4 // trigger knob, write even if it seems to hold the value
+
+typedef struct {
+    unsigned int written;  // knobs written successfully
+    unsigned int skipped;  // knobs already holding the value
+    unsigned int missing;  // knobs absent on this device
+    unsigned int failed;   // knobs present but not writable
+    unsigned int syscalls; // syscalls issued by knob writer
+} KnobStats;
+
+typedef void (*KnobErrorHandler)(const char* path, int error);
+typedef void (*KnobBaselineHandler)(const char* path, const char* value);
+typedef int (*CommandHook)(char* const argv[]);
+
+// One knob write of a dry run
+typedef struct {
+    const char* path;
+    const char* old_value; // NULL if knob can't be read
+    const char* new_value;
+    bool change;           // false if knob already holds new_value
+    long long elapsed_ns;  // time spent resolving and reading the knob
+} KnobPlan;
+
+typedef void (*KnobPlanHandler)(const KnobPlan* plan);
+
+// Per-device knob value from knob_overrides, "-" skips the knob
+typedef struct {
+    int column;
+    char path[128];
+    char value[64];
+} KnobOverride;
+
+typedef struct {
+    int soc;
+    int lite_mode;
+    int device_mitigation;
+    int dnd_gameplay;
+    int normal_baseline; // normal restores stock values of knobs other profiles changed
+    char default_cpu_gov[50];
+    char powersave_cpu_gov[50];
+    char ppm_policy[512];
+    KnobOverride overrides[MAX_KNOB_OVERRIDES];
+    int override_count;
+} ProfilerConfig;
+
+// Knob Writer
+int knob_write(const char* path, const char* value, int flags);
+void knob_set_error_handler(KnobErrorHandler handler);
+void knob_set_baseline_handler(KnobBaselineHandler handler);
+void knob_set_dry_run(KnobPlanHandler handler);
+bool knob_is_dry_run(void);
+void knob_set_sysroot(const char* dir);
+const char* knob_path(const char* path, char* buf, size_t size);
+void knob_stats_reset(void);
+void knob_get_stats(KnobStats* out);
+
+// Profiler
+void profiler_load_config(ProfilerConfig* config);
+bool profiler_is_config_file(const char* name);
+int profiler_apply(int mode, const ProfilerConfig* config);
+void profiler_restore(void);
+void profiler_set_command_hook(CommandHook hook);
+
+#endif // NUSANTARA_PROFILER_H
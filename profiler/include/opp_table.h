@@ -0,0 +1,21 @@
+#ifndef OPP_TABLE_H
+#define OPP_TABLE_H
+
+#include <stddef.h>
+
+// Frequencies a device can run at, ascending and without duplicates
+typedef struct {
+    long* freqs;
+    int* index; // MediaTek gpufreq OPP index of each frequency, NULL for others
+    size_t count;
+} OppTable;
+
+// Tables are parsed on first use and kept for the life of the process
+const OppTable* opp_table_get(const char* dir, const char* node);
+const OppTable* opp_table_gpufreq(const char* path);
+
+long opp_percentile(const OppTable* table, int percent);
+int opp_percentile_index(const OppTable* table, int percent);
+long opp_at_least(const OppTable* table, long freq);
+
+#endif // OPP_TABLE_H
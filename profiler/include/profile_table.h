@@ -0,0 +1,66 @@
+#ifndef PROFILE_TABLE_H
+#define PROFILE_TABLE_H
+
+#include <stddef.h>
+#include <nusantara_profiler.h>
+#include <topology.h>
+
+// One value column per profile, plus performance in lite mode
+#define PROFILE_COLUMNS 5
+
+// soc_recognition values
+#define SOC_MEDIATEK 1
+#define SOC_SNAPDRAGON 2
+#define SOC_EXYNOS 3
+#define SOC_UNISOC 4
+#define SOC_TENSOR 5
+#define SOC(id) (1u << (id))
+
+#define UNLOCK(column) (1u << (column))
+
+// Rule flags
+#define RULE_NO_MITIGATION 0x1 // skipped when device_mitigation is set
+#define RULE_FIRST_NODE 0x2    // only first matching node
+#define RULE_DATA_DEVICE 0x4   // only the block device holding /data
+#define RULE_PREFER 0x8        // value lists choices by preference, first one offered is written
+#define RULE_ALWAYS 0x10       // trigger knob, written on every switch
+
+typedef enum : char {
+    ACTION_NONE,
+    ACTION_DND,           // value: 1 to enable Do not Disturb
+    ACTION_BATTERY_SAVER, // value: 1 to enable battery_saver module
+    ACTION_SYNC,
+    ACTION_CONGESTION,    // value: algorithms by preference
+    ACTION_CPU,           // governor and frequency limits
+    ACTION_PPM_POLICY,    // value: 0 to disable configured PPM policies
+    ACTION_MTK_GPU,       // MediaTek GPU OPP
+} RuleAction;
+
+/*
+ * A knob, or a group of knobs, with its value in each profile.
+ *
+ * path   : knob path, "%s" is replaced by each node matching nodes/match/roles
+ * value  : indexed by PROFILER_* column, NULL leaves the knob alone.
+ *          PROFILER_LITE NULL falls back to the performance value.
+ * range  : when set, path is a directory and value is "<min>:<max>" with
+ *          min, mid or max level taken from {freqs, min_node, max_node},
+ *          or a frequency rounded up to the next OPP
+ * unlock : UNLOCK(column) mask of profiles leaving the knob writable
+ */
+typedef struct {
+    const char* path;
+    const char* value[PROFILE_COLUMNS];
+    const char* const* range;
+    const char* match; // '|' separated substrings of node name, NULL for all
+    unsigned int socs; // SOC() mask, 0 for every SoC
+    NodeSet nodes;
+    unsigned char roles; // DEVFREQ_* or BLOCK_* mask of nodes, 0 for all
+    RuleAction action;
+    unsigned char flags;
+    unsigned char unlock;
+} KnobRule;
+
+extern const KnobRule profile_rules[];
+extern const size_t profile_rule_count;
+
+#endif // PROFILE_TABLE_H
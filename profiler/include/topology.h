@@ -0,0 +1,67 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TOPOLOGY_MAX_NODES 256
+#define TOPOLOGY_MAX_RULES 256
+#define TOPOLOGY_MAX_POLICIES 16
+#define NODE_NAME_LEN 64
+
+// Devfreq roles, a device may carry several
+#define DEVFREQ_GPU 0x01
+#define DEVFREQ_DDR 0x02
+#define DEVFREQ_LLCC 0x04
+#define DEVFREQ_CPU_LAT 0x08
+#define DEVFREQ_STORAGE 0x10
+
+// Block device classes, zram, dm and loop devices are left out of the index
+#define BLOCK_UFS 0x01
+#define BLOCK_EMMC 0x02
+#define BLOCK_SD 0x04
+#define BLOCK_NVME 0x08
+#define BLOCK_DATA 0x80 // holds /data
+
+typedef enum : char {
+    NODES_NONE,
+    NODES_CPUFREQ, // cpufreq dirs relative to /sys/devices/system/cpu
+    NODES_DEVFREQ, // /sys/class/devfreq entries
+    NODES_BLOCK,   // physical /sys/block entries
+    NODES_THERMAL, // thermal zones
+    NODES_MALI,    // Mali platform device
+    NODE_SETS,
+} NodeSet;
+
+typedef enum : char {
+    GPU_UNKNOWN,
+    GPU_KGSL,       // Adreno
+    GPU_GPUFREQV2,  // MediaTek, /proc/gpufreqv2
+    GPU_GPUFREQ,    // MediaTek, /proc/gpufreq
+    GPU_EXYNOS,     // /sys/kernel/gpu
+    GPU_MALI,       // Mali platform device with devfreq-like nodes
+} GpuBackend;
+
+typedef struct {
+    uint16_t start;
+    uint16_t count;
+} NodeRange;
+
+// Everything profiles need to know about the device, saved once per boot
+typedef struct {
+    NodeRange sets[NODE_SETS];
+    uint16_t node_count;
+    char names[TOPOLOGY_MAX_NODES][NODE_NAME_LEN];
+    uint8_t roles[TOPOLOGY_MAX_NODES];               // DEVFREQ_* or BLOCK_* of each node
+    uint32_t policy_cpus[TOPOLOGY_MAX_POLICIES];     // cores behind each cpufreq dir
+    uint8_t knobs[TOPOLOGY_MAX_RULES / 8];           // profile rules whose knob exists
+    GpuBackend gpu;
+    bool has_ppm;
+} Topology;
+
+const Topology* topology_get(void);
+bool topology_knob_exists(const Topology* topology, size_t rule);
+bool node_matches(const char* name, const char* match);
+
+#endif // TOPOLOGY_H
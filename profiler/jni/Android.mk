@@ -2,7 +2,19 @@ LOCAL_PATH := $(call my-dir)
 
 include $(CLEAR_VARS)
 LOCAL_MODULE := nusantara_profiler
-LOCAL_SRC_FILES := ../src/nusantara_profiler.c
+LOCAL_SRC_FILES := \
+    ../main.c \
+    ../src/nusantara_profiler.c \
+    ../src/knob_writer.c \
+    ../src/profile_table.c \
+    ../src/topology.c \
+    ../src/knob_baseline.c \
+    ../src/opp_table.c \
+    ../../daemon/src/proc_parse.c
+
+LOCAL_C_INCLUDES := \
+    $(LOCAL_PATH)/../include \
+    $(LOCAL_PATH)/../../daemon/include
 
 LOCAL_CFLAGS := \
     -DNDEBUG \
@@ -15,7 +27,8 @@ LOCAL_CFLAGS := \
     -Wextra \
     -Wno-unused-parameter \
     -Wno-unused-variable \
-    -Wno-sign-compare
+    -Wno-sign-compare \
+    -Wno-missing-field-initializers
 
 LOCAL_LDFLAGS := \
     -flto \
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <nusantara_profiler.h>
+
+static void print_knob_error(const char *path, int error) {
+    fprintf(stderr, "Unable to write %s: %s\n", path, strerror(error));
+}
+
+static void print_value(const char *value) {
+    // Keep one knob per line and one field per column
+    for (const char *p = value; *p; p++) putchar(*p == '\t' || *p == '\n' ? ' ' : *p);
+}
+
+// Dry run plan, tab separated: action, path, old value, new value, time in ns
+static void print_plan(const KnobPlan *plan) {
+    printf("%s\t%s\t", plan->change ? "write" : "skip", plan->path);
+    print_value(plan->old_value ? plan->old_value : "-");
+    putchar('\t');
+    print_value(plan->new_value);
+    printf("\t%lld\n", plan->elapsed_ns);
+}
+
+static void print_usage(const char *name) {
+    printf("Usage: %s [--sysroot DIR] [--dry-run] <mode>\n", name);
+    printf("Modes:\n");
+    printf("  0 - Common tweaks, applied once per boot\n");
+    printf("  1 - Performance profile\n");
+    printf("  2 - Normal profile\n");
+    printf("  3 - Powersave profile\n");
+    printf("  restore - Restore stock values of every tuned knob\n");
+    printf("Options:\n");
+    printf("  --sysroot DIR - Read and write /sys, /proc and config under DIR\n");
+    printf("  --dry-run     - Print the write plan instead of writing knobs\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *sysroot = NULL;
+    bool dry_run = false;
+    int arg = 1;
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+        if (strcmp(argv[arg], "--sysroot") == 0 && arg + 1 < argc) {
+            sysroot = argv[++arg];
+        } else if (strcmp(argv[arg], "--dry-run") == 0) {
+            dry_run = true;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (arg >= argc) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    knob_set_sysroot(sysroot);
+    knob_set_error_handler(print_knob_error);
+    if (dry_run) {
+        printf("action\tpath\told\tnew\tns\n");
+        knob_set_dry_run(print_plan);
+    }
+
+    if (strcmp(argv[arg], "restore") == 0) {
+        profiler_restore();
+        return 0;
+    }
+
+    int mode = atoi(argv[arg]);
+
+    // Read configuration files
+    ProfilerConfig config;
+    profiler_load_config(&config);
+
+    if (profiler_apply(mode, &config) != 0) {
+        printf("Invalid mode: %d\n", mode);
+        return 1;
+    }
+    return 0;
+}
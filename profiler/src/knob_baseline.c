@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <knob_baseline.h>
+#include <fcntl.h>
+#include <nusantara_profiler.h>
+#include <proc_parse.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+ * Baseline file: boot_id on the first line, then one "<path> <scope> <value>"
+ * line per knob, scope is 'c' for knobs first changed by perfcommon and 'p'
+ * for the rest. Plain text so uninstall.sh can restore it without us.
+ */
+#define BASELINE_FILE "/data/adb/.config/Nusantara/baseline"
+#define JOURNAL_FILE "/data/adb/.config/Nusantara/journal"
+#define COMMON_STAGE_FILE "/data/adb/.config/Nusantara/perfcommon"
+#define BOOT_ID_LEN 40
+#define BASELINE_FILE_LEN 256
+
+typedef struct {
+    uint32_t hash;
+    bool common;  // first changed while applying perfcommon
+    bool touched; // written during the current profile
+    char path[BASELINE_PATH_LEN];
+    char value[BASELINE_VALUE_LEN];
+} BaselineKnob;
+
+static BaselineKnob knobs[BASELINE_MAX_KNOBS];
+static size_t knob_count = 0;
+static bool loaded = false;
+static bool capture_common = false;
+static int baseline_fd = -1;
+static char boot_id[BOOT_ID_LEN];
+
+static uint32_t hash_path(const char* path) {
+    uint32_t hash = 2166136261u;
+    while (*path)
+        hash = (hash ^ (unsigned char)*path++) * 16777619u;
+    return hash;
+}
+
+static BaselineKnob* find_knob(const char* path) {
+    uint32_t hash = hash_path(path);
+    for (size_t i = 0; i < knob_count; i++) {
+        if (knobs[i].hash == hash && strcmp(knobs[i].path, path) == 0)
+            return &knobs[i];
+    }
+    return NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : add_knob
+ * Inputs             : path (const char *) - knob path
+ *                      value (const char *) - stock value
+ *                      common (bool) - first changed by perfcommon
+ * Returns            : bool - true if knob is new to the baseline
+ * Description        : First value seen wins, later ones are our own writes.
+ ***********************************************************************************/
+static bool add_knob(const char* path, const char* value, bool common) {
+    if (knob_count >= BASELINE_MAX_KNOBS || strlen(path) >= BASELINE_PATH_LEN ||
+        strlen(value) >= BASELINE_VALUE_LEN || find_knob(path))
+        return false;
+
+    BaselineKnob* knob = &knobs[knob_count++];
+    knob->hash = hash_path(path);
+    knob->common = common;
+    knob->touched = false;
+    strcpy(knob->path, path);
+    strcpy(knob->value, value);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : baseline_load
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Pick up what earlier processes captured in this boot. A
+ *                      baseline of a previous boot is stale, knobs came back
+ *                      with stock values, so it is started over.
+ ***********************************************************************************/
+void baseline_load(void) {
+    if (loaded)
+        return;
+    loaded = true;
+
+    char path[BASELINE_FILE_LEN];
+    const char* boot_id_path = knob_path("/proc/sys/kernel/random/boot_id", path, sizeof(path));
+    if (read_node_string(boot_id_path, boot_id, sizeof(boot_id)) != PARSE_OK || !boot_id[0])
+        return;
+
+    const char* baseline_path = knob_path(BASELINE_FILE, path, sizeof(path));
+    char line[BASELINE_PATH_LEN + BASELINE_VALUE_LEN + 8];
+    FILE* fp = fopen(baseline_path, "r");
+    bool current = fp && fgets(line, sizeof(line), fp) && strncmp(line, boot_id, strlen(boot_id)) == 0;
+    while (current && fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\n")] = '\0';
+        char* scope = strchr(line, ' ');
+        if (!scope || !scope[1] || scope[2] != ' ')
+            continue;
+        *scope = '\0';
+        add_knob(line, scope + 3, scope[1] == 'c');
+    }
+    if (fp)
+        fclose(fp);
+
+    // A dry run only keeps what it captures in memory
+    if (knob_is_dry_run())
+        return;
+
+    if (current) {
+        baseline_fd = open(baseline_path, O_WRONLY | O_APPEND | O_CLOEXEC);
+        return;
+    }
+
+    baseline_fd = open(baseline_path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (baseline_fd != -1) {
+        int len = snprintf(line, sizeof(line), "%s\n", boot_id);
+        if (write(baseline_fd, line, len) != len) {
+            close(baseline_fd);
+            baseline_fd = -1;
+        }
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : baseline_capture
+ * Inputs             : path (const char *) - knob about to be written
+ *                      value (const char *) - value it holds now
+ * Returns            : None
+ * Description        : Knob writer baseline handler. Every knob is read before its
+ *                      first change, so a knob unknown to the baseline still holds
+ *                      its stock value.
+ ***********************************************************************************/
+void baseline_capture(const char* path, const char* value) {
+    if (!add_knob(path, value, capture_common) || baseline_fd == -1)
+        return;
+
+    // One write per line, O_APPEND keeps lines of concurrent writers whole
+    char line[BASELINE_PATH_LEN + BASELINE_VALUE_LEN + 8];
+    int len = snprintf(line, sizeof(line), "%s %c %s\n", path, capture_common ? 'c' : 'p', value);
+    if (write(baseline_fd, line, len) != len) {
+        close(baseline_fd);
+        baseline_fd = -1;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : baseline_begin
+ * Inputs             : column (int) - PROFILER_* profile about to be applied
+ * Returns            : None
+ * Description        : Tag knobs captured from now on and forget which knobs the
+ *                      previous profile touched.
+ ***********************************************************************************/
+void baseline_begin(int column) {
+    capture_common = column == PROFILER_PERFCOMMON;
+    for (size_t i = 0; i < knob_count; i++)
+        knobs[i].touched = false;
+}
+
+/***********************************************************************************
+ * Function Name      : baseline_value
+ * Inputs             : path (const char *) - knob path
+ * Returns            : const char * - stock value of a knob changed by profiles,
+ *                                     NULL if unknown or owned by perfcommon
+ ***********************************************************************************/
+const char* baseline_value(const char* path) {
+    const BaselineKnob* knob = find_knob(path);
+    return knob && !knob->common ? knob->value : NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : baseline_is_stock
+ * Inputs             : path (const char *) - knob path
+ * Returns            : bool - true if no profile changed the knob in this boot
+ * Description        : Every change is captured first, so a knob the baseline
+ *                      doesn't know still holds its stock value. Without a boot_id
+ *                      nothing is captured and nothing can be told apart.
+ ***********************************************************************************/
+bool baseline_is_stock(const char* path) {
+    return boot_id[0] && !find_knob(path);
+}
+
+/***********************************************************************************
+ * Function Name      : baseline_touch
+ * Inputs             : path (const char *) - knob written by current profile
+ * Returns            : None
+ ***********************************************************************************/
+void baseline_touch(const char* path) {
+    BaselineKnob* knob = find_knob(path);
+    if (knob)
+        knob->touched = true;
+}
+
+/***********************************************************************************
+ * Function Name      : baseline_restore
+ * Inputs             : all (bool) - true to restore every knob, false for knobs
+ *                                   changed by profiles and not touched since
+ *                                   baseline_begin()
+ * Returns            : None
+ * Description        : Write stock values back and leave knobs writable. Knobs
+ *                      restored in capture order may briefly conflict, e.g. a
+ *                      min_freq above the max_freq restored after it, so failed
+ *                      ones get a second try. Restoring all knobs undoes
+ *                      perfcommon as well.
+ ***********************************************************************************/
+void baseline_restore(bool all) {
+    bool failed[BASELINE_MAX_KNOBS] = {false};
+    bool retry = false;
+
+    if (all && !knob_is_dry_run()) {
+        char path[BASELINE_FILE_LEN];
+        unlink(knob_path(COMMON_STAGE_FILE, path, sizeof(path)));
+    }
+
+    for (size_t i = 0; i < knob_count; i++) {
+        BaselineKnob* knob = &knobs[i];
+        if (!all && (knob->common || knob->touched))
+            continue;
+        knob->touched = true;
+        failed[i] = knob_write(knob->path, knob->value, KNOB_UNLOCK) < 0;
+        retry |= failed[i];
+    }
+
+    for (size_t i = 0; retry && i < knob_count; i++) {
+        if (failed[i])
+            knob_write(knobs[i].path, knobs[i].value, KNOB_UNLOCK);
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : journal_pending
+ * Inputs             : None
+ * Returns            : bool - true if a profile switch didn't finish
+ ***********************************************************************************/
+bool journal_pending(void) {
+    char path[BASELINE_FILE_LEN];
+    return access(knob_path(JOURNAL_FILE, path, sizeof(path)), F_OK) == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : journal_begin
+ * Inputs             : mode (int) - profile being applied
+ * Returns            : None
+ * Description        : Mark a profile switch as in progress until journal_commit().
+ ***********************************************************************************/
+void journal_begin(int mode) {
+    if (knob_is_dry_run())
+        return;
+
+    char path[BASELINE_FILE_LEN];
+    const char* journal_path = knob_path(JOURNAL_FILE, path, sizeof(path));
+    int fd = open(journal_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return;
+
+    char line[16];
+    int len = snprintf(line, sizeof(line), "%d\n", mode);
+    if (write(fd, line, len) != len)
+        unlink(journal_path);
+    close(fd);
+}
+
+/***********************************************************************************
+ * Function Name      : journal_commit
+ * Inputs             : None
+ * Returns            : None
+ ***********************************************************************************/
+void journal_commit(void) {
+    if (knob_is_dry_run())
+        return;
+
+    char path[BASELINE_FILE_LEN];
+    unlink(knob_path(JOURNAL_FILE, path, sizeof(path)));
+}
+
+/***********************************************************************************
+ * Function Name      : common_stage_done
+ * Inputs             : signature (uint32_t) - hash of what perfcommon depends on
+ * Returns            : bool - true if perfcommon already ran in this boot with
+ *                            the same signature
+ * Description        : Needs baseline_load() to have read the boot_id.
+ ***********************************************************************************/
+bool common_stage_done(uint32_t signature) {
+    if (!boot_id[0])
+        return false;
+
+    char path[BASELINE_FILE_LEN];
+    char line[BOOT_ID_LEN + 16];
+    char expected[BOOT_ID_LEN + 16];
+    if (read_node_string(knob_path(COMMON_STAGE_FILE, path, sizeof(path)), line, sizeof(line)) != PARSE_OK)
+        return false;
+    snprintf(expected, sizeof(expected), "%s %08x", boot_id, signature);
+    return strcmp(line, expected) == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : common_stage_record
+ * Inputs             : signature (uint32_t) - hash of what perfcommon depends on
+ * Returns            : None
+ * Description        : Written through a temporary file so a torn record never
+ *                      matches.
+ ***********************************************************************************/
+void common_stage_record(uint32_t signature) {
+    if (!boot_id[0] || knob_is_dry_run())
+        return;
+
+    char path[BASELINE_FILE_LEN];
+    char tmp_path[BASELINE_FILE_LEN + 4];
+    const char* stage_path = knob_path(COMMON_STAGE_FILE, path, sizeof(path));
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", stage_path);
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return;
+
+    char line[BOOT_ID_LEN + 16];
+    int len = snprintf(line, sizeof(line), "%s %08x\n", boot_id, signature);
+    bool ok = write(fd, line, len) == len;
+    close(fd);
+    if (!ok || rename(tmp_path, stage_path) != 0)
+        unlink(tmp_path);
+}
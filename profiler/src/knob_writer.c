@@ -0,0 +1,546 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <nusantara_profiler.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define KNOB_LOCKED_MODE 0444
+#define KNOB_UNLOCKED_MODE 0644
+#define KNOB_SHADOW_SIZE 1024 // power of two
+#define KNOB_READ_MAX 512
+#define KNOB_PATH_MAX 256
+
+typedef struct {
+    const char* path;
+    size_t len;
+    int fd;
+} KnobRoot;
+
+// Most specific first, knobs are opened relative to the first matching root
+static KnobRoot roots[] = {
+    {"/sys/devices/system/cpu", sizeof("/sys/devices/system/cpu") - 1, -1},
+    {"/sys/class/devfreq", sizeof("/sys/class/devfreq") - 1, -1},
+    {"/sys/block", sizeof("/sys/block") - 1, -1},
+    {"/sys/module", sizeof("/sys/module") - 1, -1},
+    {"/sys/kernel", sizeof("/sys/kernel") - 1, -1},
+    {"/proc/sys", sizeof("/proc/sys") - 1, -1},
+    {"/sys", sizeof("/sys") - 1, -1},
+    {"/proc", sizeof("/proc") - 1, -1},
+    {"/", 0, -1}, // anything else, also keeps knobs inside sysroot
+};
+
+// Last value written to each knob, keyed by path hash
+typedef struct {
+    uint64_t path_hash;
+    uint64_t value_hash;
+    bool locked;
+} KnobShadow;
+
+static KnobShadow shadow[KNOB_SHADOW_SIZE];
+static KnobStats stats;
+static KnobErrorHandler error_handler = NULL;
+static KnobBaselineHandler baseline_handler = NULL;
+static KnobPlanHandler plan_handler = NULL;
+static const char* sysroot = NULL;
+
+/***********************************************************************************
+ * Function Name      : resolve_knob
+ * Inputs             : path (const char *) - absolute knob path
+ *                      relative (const char **) - receives path relative to dir fd
+ * Returns            : int - cached directory fd, -1 if none of the roots opens
+ * Description        : Map a knob to a cached directory fd so the kernel only walks
+ *                      the last few path components on every open.
+ ***********************************************************************************/
+static int resolve_knob(const char* path, const char** relative) {
+    for (size_t i = 0; i < sizeof(roots) / sizeof(roots[0]); i++) {
+        KnobRoot* root = &roots[i];
+        if (strncmp(path, root->path, root->len) != 0 || path[root->len] != '/')
+            continue;
+
+        if (root->fd == -1) {
+            char buf[KNOB_PATH_MAX];
+            stats.syscalls++;
+            root->fd = open(knob_path(root->path, buf, sizeof(buf)), O_PATH | O_DIRECTORY | O_CLOEXEC);
+            // Missing root, fall back to a wider one
+            if (root->fd == -1)
+                continue;
+        }
+
+        *relative = path + root->len + 1;
+        return root->fd;
+    }
+
+    return -1;
+}
+
+/***********************************************************************************
+ * Function Name      : hash_string
+ * Inputs             : str (const char *) - string to hash
+ *                      len (size_t) - length of str
+ * Returns            : uint64_t - FNV-1a hash, never 0
+ ***********************************************************************************/
+static uint64_t hash_string(const char* str, size_t len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)str[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash ? hash : 1;
+}
+
+/***********************************************************************************
+ * Function Name      : find_shadow
+ * Inputs             : path_hash (uint64_t) - hash of knob path
+ * Returns            : KnobShadow * - slot of the knob, or a free slot
+ * Description        : Open addressing lookup. When the table is full the home
+ *                      slot is recycled, losing a shadow only costs a read.
+ ***********************************************************************************/
+static KnobShadow* find_shadow(uint64_t path_hash) {
+    size_t home = path_hash & (KNOB_SHADOW_SIZE - 1);
+    for (size_t i = 0; i < KNOB_SHADOW_SIZE; i++) {
+        KnobShadow* slot = &shadow[(home + i) & (KNOB_SHADOW_SIZE - 1)];
+        if (slot->path_hash == path_hash || slot->path_hash == 0)
+            return slot;
+    }
+
+    shadow[home].path_hash = 0;
+    return &shadow[home];
+}
+
+/***********************************************************************************
+ * Function Name      : next_token
+ * Inputs             : str (const char **) - cursor, advanced past the token
+ *                      end (const char *) - end of buffer
+ *                      len (size_t *) - receives token length
+ * Returns            : const char * - start of token, NULL when none is left
+ ***********************************************************************************/
+static const char* next_token(const char** str, const char* end, size_t* len) {
+    const char* p = *str;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n'))
+        p++;
+    if (p == end)
+        return NULL;
+
+    const char* start = p;
+    while (p < end && *p != ' ' && *p != '\t' && *p != '\n')
+        p++;
+
+    *len = p - start;
+    *str = p;
+    return start;
+}
+
+/***********************************************************************************
+ * Function Name      : is_set_knob
+ * Inputs             : path (const char *) - knob path
+ * Returns            : bool - true if each write toggles one item of a set
+ * Description        : Such knobs hold more than the last written value, so their
+ *                      shadow can't be trusted.
+ ***********************************************************************************/
+static bool is_set_knob(const char* path) {
+    size_t len = strlen(path);
+    return len >= 14 && strcmp(path + len - 14, "sched_features") == 0;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_holds_value
+ * Inputs             : path (const char *) - knob path
+ *                      current (const char *) - value read from knob
+ *                      current_len (size_t) - length of current
+ *                      value (const char *) - value about to be written
+ * Returns            : bool - true if writing value would change nothing
+ * Description        : Compare ignoring whitespace differences. Selector knobs such
+ *                      as I/O scheduler list all choices and bracket the active
+ *                      one, sched_features lists every feature currently set.
+ ***********************************************************************************/
+static bool knob_holds_value(const char* path, const char* current, size_t current_len, const char* value) {
+    const char* cur_end = current + current_len;
+    const char* val_end = value + strlen(value);
+
+    const char* bracket = memchr(current, '[', current_len);
+    if (bracket) {
+        const char* close = memchr(bracket, ']', cur_end - bracket);
+        const char* val = value;
+        size_t len;
+        const char* token = next_token(&val, val_end, &len);
+        return close && token && !next_token(&val, val_end, &len) && (size_t)(close - bracket - 1) == len &&
+               memcmp(bracket + 1, token, len) == 0;
+    }
+
+    if (is_set_knob(path)) {
+        size_t len, cur_len;
+        const char* val = value;
+        const char* token = next_token(&val, val_end, &len);
+        const char* cur = current;
+        const char* cur_token;
+        while (token && (cur_token = next_token(&cur, cur_end, &cur_len))) {
+            if (cur_len == len && memcmp(cur_token, token, len) == 0)
+                return !next_token(&val, val_end, &len);
+        }
+        return false;
+    }
+
+    // Same tokens in the same order
+    const char* cur = current;
+    const char* val = value;
+    for (;;) {
+        size_t cur_len, val_len;
+        const char* cur_token = next_token(&cur, cur_end, &cur_len);
+        const char* val_token = next_token(&val, val_end, &val_len);
+        if (!cur_token || !val_token)
+            return !cur_token && !val_token;
+        if (cur_len != val_len || memcmp(cur_token, val_token, cur_len) != 0)
+            return false;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : report_baseline
+ * Inputs             : path (const char *) - knob path
+ *                      current (const char *) - value read from knob
+ *                      current_len (size_t) - length of current
+ * Returns            : None
+ * Description        : Pass what the knob held before our write to the baseline
+ *                      handler, in the form that writes it back. Selector knobs
+ *                      report their active choice, set knobs and multi-line
+ *                      dumps can't be written back and are not reported.
+ ***********************************************************************************/
+static void report_baseline(const char* path, const char* current, size_t current_len) {
+    if (!baseline_handler || is_set_knob(path))
+        return;
+
+    const char* start = current;
+    const char* end = current + current_len;
+    const char* bracket = memchr(current, '[', current_len);
+    if (bracket) {
+        const char* close = memchr(bracket, ']', end - bracket);
+        if (!close)
+            return;
+        start = bracket + 1;
+        end = close;
+    }
+
+    while (end > start && (end[-1] == '\n' || end[-1] == ' '))
+        end--;
+    if (memchr(start, '\n', end - start))
+        return;
+
+    char value[KNOB_READ_MAX];
+    memcpy(value, start, end - start);
+    value[end - start] = '\0';
+    baseline_handler(path, value);
+}
+
+/***********************************************************************************
+ * Function Name      : report_error
+ * Inputs             : path (const char *) - knob path
+ *                      error (int) - errno of failed operation
+ * Returns            : int - negated error
+ * Description        : Count a failed write and pass it to the error handler.
+ ***********************************************************************************/
+static int report_error(const char* path, int error) {
+    stats.failed++;
+    if (error_handler)
+        error_handler(path, error);
+    return -error;
+}
+
+/***********************************************************************************
+ * Function Name      : plan_knob
+ * Inputs             : path (const char *) - absolute knob path
+ *                      value (const char *) - value that would be written
+ *                      always (bool) - trigger knob, written whatever it holds
+ * Returns            : int - 0, or -ENOENT if knob doesn't exist
+ * Description        : Dry run of knob_write(). Read the knob and tell the plan
+ *                      handler whether it would change, nothing is written.
+ ***********************************************************************************/
+static int plan_knob(const char* path, const char* value, bool always) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    const char* relative;
+    int dir_fd = resolve_knob(path, &relative);
+    int fd = -1;
+    if (dir_fd != -1) {
+        stats.syscalls++;
+        fd = openat(dir_fd, relative, O_RDONLY | O_CLOEXEC);
+    }
+
+    char current[KNOB_READ_MAX];
+    ssize_t current_len = -1;
+    if (fd != -1) {
+        stats.syscalls += 2;
+        current_len = read(fd, current, sizeof(current) - 1);
+        close(fd);
+    } else if (dir_fd == -1 || (errno != EACCES && errno != EPERM)) {
+        // Write-only attributes still get planned, with an unknown old value
+        stats.missing++;
+        return -ENOENT;
+    }
+
+    KnobPlan plan = {.path = path, .old_value = NULL, .new_value = value, .change = true};
+    if (current_len >= 0) {
+        current[current_len] = '\0';
+        if (!always)
+            report_baseline(path, current, current_len);
+        plan.change = always || !knob_holds_value(path, current, current_len, value);
+        current[strcspn(current, "\n")] = '\0';
+        plan.old_value = current;
+    }
+    if (plan.change)
+        stats.written++;
+    else
+        stats.skipped++;
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    plan.elapsed_ns = (end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec);
+    plan_handler(&plan);
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_write
+ * Inputs             : path (const char *) - absolute knob path
+ *                      value (const char *) - value to write
+ *                      flags (int) - KNOB_LOCK to make knob read-only afterwards,
+ *                                    KNOB_UNLOCK to leave it writable for others,
+ *                                    KNOB_ALWAYS to write trigger knobs like
+ *                                    drop_caches every time
+ * Returns            : int - 0 on success, -ENOENT if knob doesn't exist on this
+ *                           device, other negative errno if write failed
+ * Description        : Write a knob with one openat() and one pwrite(), skipping the
+ *                      write when knob already holds value. A knob we locked with
+ *                      another value is written without reading it first, any
+ *                      other knob is read and compared. The shadow is only a hint,
+ *                      other root writers like a restore from the command line,
+ *                      uninstall.sh or vendor init may have changed a locked knob.
+ *                      Permissions are only touched when they block root from
+ *                      writing, or when caller asks to lock or unlock the knob.
+ ***********************************************************************************/
+int knob_write(const char* path, const char* value, int flags) {
+    size_t len = strlen(value);
+    bool always = flags & KNOB_ALWAYS;
+    uint64_t path_hash = hash_string(path, strlen(path));
+    uint64_t value_hash = hash_string(value, len);
+    KnobShadow* entry = find_shadow(path_hash);
+    bool known = !always && entry->path_hash == path_hash && entry->locked && !is_set_knob(path);
+
+    if (plan_handler)
+        return plan_knob(path, value, always);
+
+    const char* relative;
+    int dir_fd = resolve_knob(path, &relative);
+    if (dir_fd == -1) {
+        stats.missing++;
+        return -ENOENT;
+    }
+
+    // Read current value unless the shadow already tells it differs
+    bool readable = !always && !(known && entry->value_hash != value_hash);
+    stats.syscalls++;
+    int fd = openat(dir_fd, relative, (readable ? O_RDWR : O_WRONLY) | O_CLOEXEC);
+    if (fd == -1 && readable && (errno == EACCES || errno == EPERM)) {
+        // Write-only attribute, or a knob locked by someone else
+        readable = false;
+        stats.syscalls++;
+        fd = openat(dir_fd, relative, O_WRONLY | O_CLOEXEC);
+    }
+    if (fd == -1 && (errno == EACCES || errno == EPERM)) {
+        // Root without CAP_DAC_OVERRIDE, e.g. a knob we locked earlier
+        stats.syscalls++;
+        if (fchmodat(dir_fd, relative, KNOB_UNLOCKED_MODE, 0) == 0) {
+            stats.syscalls++;
+            fd = openat(dir_fd, relative, O_WRONLY | O_CLOEXEC);
+        }
+    }
+
+    if (fd == -1) {
+        if (errno == ENOENT || errno == ENOTDIR) {
+            stats.missing++;
+            return -ENOENT;
+        }
+        return report_error(path, errno);
+    }
+
+    bool same = false;
+    if (readable) {
+        char current[KNOB_READ_MAX];
+        stats.syscalls++;
+        ssize_t current_len = read(fd, current, sizeof(current));
+        // A full buffer may be truncated, just write in that case
+        bool complete = current_len >= 0 && current_len < (ssize_t)sizeof(current);
+        same = complete && knob_holds_value(path, current, current_len, value);
+        if (complete)
+            report_baseline(path, current, current_len);
+    }
+
+    int error = 0;
+    if (!same) {
+        // Offset 0, sysctl ignores writes past the start after our read
+        ssize_t written;
+        do {
+            stats.syscalls++;
+            written = pwrite(fd, value, len, 0);
+        } while (written == -1 && errno == EINTR);
+        error = (written == -1) ? errno : 0;
+
+        // Sysroot knobs are regular files, drop what's left of a longer value
+        if (!error && sysroot) {
+            stats.syscalls++;
+            if (ftruncate(fd, written) == -1)
+                error = errno;
+        }
+    }
+
+    if (flags & KNOB_LOCK) {
+        stats.syscalls++;
+        fchmod(fd, KNOB_LOCKED_MODE);
+    } else if (flags & KNOB_UNLOCK) {
+        struct stat st;
+        stats.syscalls++;
+        if (fstat(fd, &st) == 0 && (st.st_mode & 0777) != KNOB_UNLOCKED_MODE) {
+            stats.syscalls++;
+            fchmod(fd, KNOB_UNLOCKED_MODE);
+        }
+    }
+
+    stats.syscalls++;
+    close(fd);
+
+    if (error || always) {
+        entry->path_hash = 0;
+        if (error)
+            return report_error(path, error);
+        stats.written++;
+        return 0;
+    }
+
+    entry->path_hash = path_hash;
+    entry->value_hash = value_hash;
+    entry->locked = flags & KNOB_LOCK;
+
+    if (same)
+        stats.skipped++;
+    else
+        stats.written++;
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_set_error_handler
+ * Inputs             : handler (KnobErrorHandler) - called for every failed write,
+ *                                                   NULL to disable
+ * Returns            : None
+ * Description        : Let the caller decide how write failures are reported.
+ ***********************************************************************************/
+void knob_set_error_handler(KnobErrorHandler handler) {
+    error_handler = handler;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_set_baseline_handler
+ * Inputs             : handler (KnobBaselineHandler) - called with the value a knob
+ *                                                      holds before we write it,
+ *                                                      NULL to disable
+ * Returns            : None
+ * Description        : Let the caller remember stock values to restore later.
+ * Note               : Knobs we locked with another value are written without
+ *                      reading them, the handler saw them on their first write.
+ ***********************************************************************************/
+void knob_set_baseline_handler(KnobBaselineHandler handler) {
+    baseline_handler = handler;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_set_dry_run
+ * Inputs             : handler (KnobPlanHandler) - receives every knob write in
+ *                                                  order instead of it being done,
+ *                                                  NULL to write knobs again
+ * Returns            : None
+ ***********************************************************************************/
+void knob_set_dry_run(KnobPlanHandler handler) {
+    plan_handler = handler;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_is_dry_run
+ * Inputs             : None
+ * Returns            : bool - true if writes are only planned, callers skip their
+ *                             other side effects too
+ ***********************************************************************************/
+bool knob_is_dry_run(void) {
+    return plan_handler != NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_set_sysroot
+ * Inputs             : dir (const char *) - directory holding a copy of /sys, /proc
+ *                                           and the module config, NULL for /
+ * Returns            : None
+ * Description        : Resolve every absolute path under dir, so profiles can be
+ *                      applied to a fake tree on a build host.
+ ***********************************************************************************/
+void knob_set_sysroot(const char* dir) {
+    sysroot = dir && dir[0] && strcmp(dir, "/") != 0 ? dir : NULL;
+    for (size_t i = 0; i < sizeof(roots) / sizeof(roots[0]); i++) {
+        if (roots[i].fd != -1)
+            close(roots[i].fd);
+        roots[i].fd = -1;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : knob_path
+ * Inputs             : path (const char *) - absolute path on the device
+ *                      buf (char *) - buffer for the resolved path
+ *                      size (size_t) - size of buf
+ * Returns            : const char * - path under sysroot, or path itself when no
+ *                                     sysroot is set
+ ***********************************************************************************/
+const char* knob_path(const char* path, char* buf, size_t size) {
+    if (!sysroot || path[0] != '/')
+        return path;
+
+    snprintf(buf, size, "%s%s", sysroot, path);
+    return buf;
+}
+
+/***********************************************************************************
+ * Function Name      : knob_stats_reset
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Start counting a new batch of writes.
+ ***********************************************************************************/
+void knob_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+/***********************************************************************************
+ * Function Name      : knob_get_stats
+ * Inputs             : out (KnobStats *) - receives counters since last reset
+ * Returns            : None
+ * Description        : Fetch write and syscall counters of the current batch.
+ ***********************************************************************************/
+void knob_get_stats(KnobStats* out) {
+    *out = stats;
+}
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <opp_table.h>
+#include <nusantara_profiler.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OPP_PATH_LEN 256
+
+typedef enum : char {
+    OPP_LIST,          // whitespace separated frequencies
+    OPP_TIME_IN_STATE, // "<freq> <time>" per line
+    OPP_GPUFREQ,       // MediaTek "[<index>] freq = <freq>, ..." per line
+} OppFormat;
+
+// Parsed tables, missing ones are kept empty so they aren't probed again
+typedef struct OppEntry {
+    struct OppEntry* next;
+    char path[OPP_PATH_LEN];
+    OppTable table;
+} OppEntry;
+
+static OppEntry* entries = NULL;
+
+typedef struct {
+    long freq;
+    int index;
+} Opp;
+
+static int compare_opp(const void* a, const void* b) {
+    long fa = ((const Opp*)a)->freq, fb = ((const Opp*)b)->freq;
+    return (fa > fb) - (fa < fb);
+}
+
+/***********************************************************************************
+ * Function Name      : add_opp
+ * Inputs             : opps (Opp **) - growing array
+ *                      count (size_t *) - entries in use
+ *                      capacity (size_t *) - entries allocated
+ *                      freq (long) - frequency
+ *                      index (int) - OPP index, -1 if the format has none
+ * Returns            : bool - false if out of memory
+ * Description        : Idle states listed as 0 aren't a frequency to run at.
+ ***********************************************************************************/
+static bool add_opp(Opp** opps, size_t* count, size_t* capacity, long freq, int index) {
+    if (freq <= 0)
+        return true;
+
+    if (*count == *capacity) {
+        size_t grown = *capacity ? *capacity * 2 : 32;
+        Opp* resized = realloc(*opps, grown * sizeof(Opp));
+        if (!resized)
+            return false;
+        *opps = resized;
+        *capacity = grown;
+    }
+    (*opps)[*count].freq = freq;
+    (*opps)[(*count)++].index = index;
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : parse_line
+ * Inputs             : line (const char *) - one line of the table node
+ *                      format (OppFormat) - layout of the node
+ *                      opps, count, capacity - array receiving frequencies
+ * Returns            : bool - false if out of memory
+ ***********************************************************************************/
+static bool parse_line(const char* line, OppFormat format, Opp** opps, size_t* count, size_t* capacity) {
+    char* end;
+    if (format == OPP_LIST) {
+        for (long freq = strtol(line, &end, 10); end != line; freq = strtol(line, &end, 10)) {
+            if (!add_opp(opps, count, capacity, freq, -1))
+                return false;
+            line = end;
+        }
+        return true;
+    }
+
+    if (format == OPP_TIME_IN_STATE) {
+        long freq = strtol(line, &end, 10);
+        return end == line || add_opp(opps, count, capacity, freq, -1);
+    }
+
+    // gpufreq_opp_dump uses "freq = ", gpufreqv2 tables use "freq: "
+    const char* bracket = strchr(line, '[');
+    const char* freq = strstr(line, "freq");
+    if (!bracket || !freq)
+        return true;
+    freq += strspn(freq + 4, " ") + 4;
+    if (*freq != '=' && *freq != ':')
+        return true;
+    int index = (int)strtol(bracket + 1, &end, 10);
+    if (end == bracket + 1)
+        return true;
+    return add_opp(opps, count, capacity, strtol(freq + 1, NULL, 10), index);
+}
+
+/***********************************************************************************
+ * Function Name      : parse_table
+ * Inputs             : path (const char *) - table node
+ *                      format (OppFormat) - layout of the node
+ *                      table (OppTable *) - receives sorted frequencies
+ * Returns            : bool - true if the node had any frequency
+ * Description        : No fixed limit on OPP count, tables of any size are read
+ *                      whole. Lines are read with getline() since procfs dumps
+ *                      may span more than a page.
+ ***********************************************************************************/
+static bool parse_table(const char* path, OppFormat format, OppTable* table) {
+    char buf[OPP_PATH_LEN];
+    FILE* fp = fopen(knob_path(path, buf, sizeof(buf)), "re");
+    if (!fp)
+        return false;
+
+    Opp* opps = NULL;
+    size_t count = 0, capacity = 0;
+    char* line = NULL;
+    size_t line_size = 0;
+    bool ok = true;
+    while (ok && getline(&line, &line_size, fp) != -1)
+        ok = parse_line(line, format, &opps, &count, &capacity);
+    free(line);
+    fclose(fp);
+
+    if (!ok || count == 0) {
+        free(opps);
+        return false;
+    }
+
+    // Sort ascending and merge duplicates, the first index listed is kept
+    qsort(opps, count, sizeof(Opp), compare_opp);
+    table->freqs = malloc(count * sizeof(long));
+    table->index = format == OPP_GPUFREQ ? malloc(count * sizeof(int)) : NULL;
+    if (!table->freqs || (format == OPP_GPUFREQ && !table->index)) {
+        free(table->freqs);
+        free(table->index);
+        free(opps);
+        table->freqs = NULL;
+        table->index = NULL;
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (table->count && table->freqs[table->count - 1] == opps[i].freq)
+            continue;
+        if (table->index)
+            table->index[table->count] = opps[i].index;
+        table->freqs[table->count++] = opps[i].freq;
+    }
+    free(opps);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : find_entry
+ * Inputs             : path (const char *) - node the table is known by
+ *                      found (bool *) - set to true if already cached
+ * Returns            : OppEntry * - cached or new entry, NULL if out of memory
+ ***********************************************************************************/
+static OppEntry* find_entry(const char* path, bool* found) {
+    for (OppEntry* entry = entries; entry; entry = entry->next) {
+        if (strcmp(entry->path, path) == 0) {
+            *found = true;
+            return entry;
+        }
+    }
+
+    *found = false;
+    OppEntry* entry = calloc(1, sizeof(OppEntry));
+    if (!entry)
+        return NULL;
+    snprintf(entry->path, sizeof(entry->path), "%s", path);
+    entry->next = entries;
+    entries = entry;
+    return entry;
+}
+
+/***********************************************************************************
+ * Function Name      : opp_table_get
+ * Inputs             : dir (const char *) - cpufreq policy, devfreq or GPU directory
+ *                      node (const char *) - frequency list inside dir
+ * Returns            : const OppTable * - table, NULL if none could be read
+ * Description        : cpufreq drivers that don't list scaling_available_frequencies
+ *                      still report every OPP in stats/time_in_state.
+ ***********************************************************************************/
+const OppTable* opp_table_get(const char* dir, const char* node) {
+    char path[OPP_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/%s", dir, node);
+    bool found;
+    OppEntry* entry = find_entry(path, &found);
+    if (!entry)
+        return NULL;
+
+    if (!found && !parse_table(path, OPP_LIST, &entry->table)) {
+        snprintf(path, sizeof(path), "%s/stats/time_in_state", dir);
+        parse_table(path, OPP_TIME_IN_STATE, &entry->table);
+    }
+    return entry->table.count ? &entry->table : NULL;
+}
+
+/***********************************************************************************
+ * Function Name      : opp_table_gpufreq
+ * Inputs             : path (const char *) - gpufreq_opp_dump or gpu_working_opp_table
+ * Returns            : const OppTable * - table with OPP indices, NULL if none
+ ***********************************************************************************/
+const OppTable* opp_table_gpufreq(const char* path) {
+    bool found;
+    OppEntry* entry = find_entry(path, &found);
+    if (!entry)
+        return NULL;
+
+    if (!found)
+        parse_table(path, OPP_GPUFREQ, &entry->table);
+    return entry->table.count ? &entry->table : NULL;
+}
+
+static size_t percentile_position(const OppTable* table, int percent) {
+    if (percent < 0)
+        percent = 0;
+    if (percent > 100)
+        percent = 100;
+    // Nearest rank, 0 is the lowest OPP, 50 the middle one, 100 the highest
+    return ((table->count - 1) * percent + 50) / 100;
+}
+
+/***********************************************************************************
+ * Function Name      : opp_percentile
+ * Inputs             : table (const OppTable *) - table, may be NULL
+ *                      percent (int) - 0 to 100
+ * Returns            : long - frequency at that rank, 0 without table
+ ***********************************************************************************/
+long opp_percentile(const OppTable* table, int percent) {
+    return table ? table->freqs[percentile_position(table, percent)] : 0;
+}
+
+/***********************************************************************************
+ * Function Name      : opp_percentile_index
+ * Inputs             : table (const OppTable *) - gpufreq table, may be NULL
+ *                      percent (int) - 0 to 100
+ * Returns            : int - OPP index of the frequency at that rank, 0 without
+ *                            table, which is the highest OPP on MediaTek
+ ***********************************************************************************/
+int opp_percentile_index(const OppTable* table, int percent) {
+    return table && table->index ? table->index[percentile_position(table, percent)] : 0;
+}
+
+/***********************************************************************************
+ * Function Name      : opp_at_least
+ * Inputs             : table (const OppTable *) - table, may be NULL
+ *                      freq (long) - requested frequency
+ * Returns            : long - lowest OPP at or above freq, highest OPP if freq is
+ *                             above all of them, 0 without table
+ ***********************************************************************************/
+long opp_at_least(const OppTable* table, long freq) {
+    if (!table)
+        return 0;
+
+    size_t low = 0, high = table->count - 1;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if (table->freqs[mid] < freq)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return table->freqs[low];
+}
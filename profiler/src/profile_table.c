@@ -0,0 +1,237 @@
+#include <profile_table.h>
+
+// Range layouts: {available frequencies, min node, max node}
+static const char* const devfreq_range[] = {"available_frequencies", "min_freq", "max_freq"};
+static const char* const bus_dcvs_range[] = {"available_frequencies", "hw_min_freq", "hw_max_freq"};
+static const char* const exynos_gpu_range[] = {"gpu_available_frequencies", "gpu_min_clock", "gpu_max_clock"};
+static const char* const mali_range[] = {"available_frequencies", "scaling_min_freq", "scaling_max_freq"};
+
+/*
+ * Rules run top to bottom, perfcommon column first. Value columns are
+ * { perfcommon, performance, normal, powersave, lite }.
+ */
+const KnobRule profile_rules[] = {
+    // Disable Kernel panic
+    {"/proc/sys/kernel/panic", {"0"}},
+    {"/proc/sys/vm/panic_on_oom", {"0"}},
+    {"/proc/sys/kernel/panic_on_oops", {"0"}},
+    {"/proc/sys/kernel/panic_on_warn", {"0"}},
+    {"/proc/sys/kernel/softlockup_panic", {"0"}},
+
+    // Sync to data
+    {NULL, {"1"}, .action = ACTION_SYNC},
+
+    // I/O Tweaks
+    {"/sys/block/%s/queue/iostats", {"0"}, .nodes = NODES_BLOCK},
+    {"/sys/block/%s/queue/add_random", {"0"}, .nodes = NODES_BLOCK},
+
+    // Networking tweaks
+    {"/proc/sys/net/ipv4/tcp_congestion_control", {"bbr3 bbr2 bbrplus bbr westwood cubic"},
+     .action = ACTION_CONGESTION},
+    {"/proc/sys/net/ipv4/tcp_sack", {"1"}},
+    {"/proc/sys/net/ipv4/tcp_fack", {"1"}},
+    {"/proc/sys/net/ipv4/tcp_ecn", {"2"}},
+    {"/proc/sys/net/ipv4/tcp_window_scaling", {"1"}},
+    {"/proc/sys/net/ipv4/tcp_moderate_rcvbuf", {"1"}},
+    {"/proc/sys/net/ipv4/tcp_fastopen", {"3"}},
+
+    // Limit max perf event processing time
+    {"/proc/sys/kernel/perf_cpu_time_max_percent", {"3"}},
+
+    // Disable schedstats and Oppo/Realme cpustats
+    {"/proc/sys/kernel/sched_schedstats", {"0"}},
+    {"/proc/sys/kernel/task_cpustats_enable", {"0"}},
+
+    // VM Writeback Control, update /proc/stat less often
+    {"/proc/sys/vm/stat_interval", {"15"}},
+    {"/proc/sys/vm/page-cluster", {"0"}},
+    {"/proc/sys/vm/overcommit_ratio", {"80"}},
+
+    // Disable Sched auto group, enable CRF
+    {"/proc/sys/kernel/sched_autogroup_enabled", {"0"}},
+    {"/proc/sys/kernel/sched_child_runs_first", {"1"}},
+
+    // Disable SPI CRC, OnePlus opchain and Oplus bloats
+    {"/sys/module/mmc_core/parameters/use_spi_crc", {"0"}},
+    {"/sys/module/opchain/parameters/chain_on", {"0"}},
+    {"/sys/module/cpufreq_bouncing/parameters/enable", {"0"}},
+    {"/proc/task_info/task_sched_info/task_sched_info_enable", {"0"}},
+    {"/proc/oplus_scheduler/sched_assist/sched_assist_enabled", {"0"}},
+
+    // Reduce kernel log noise
+    {"/proc/sys/kernel/printk", {"0"}},
+    {"/proc/sys/kernel/printk_devkmsg", {"off"}},
+
+    // Report max CPU capabilities
+    {"/proc/sys/kernel/sched_lib_name",
+     {"libunity.so, libil2cpp.so, libmain.so, libUE4.so, libgodot_android.so, libgdx.so, libgdx-box2d.so, "
+      "libminecraftpe.so, libLive2DCubismCore.so, libyuzu-android.so, libryujinx.so, libcitra-android.so, "
+      "libhdr_pro_engine.so, libandroidx.graphics.path.so, libeffect.so"}},
+    {"/proc/sys/kernel/sched_lib_mask_force", {"255"}},
+
+    // Set thermal governor to step_wise
+    {"/sys/class/thermal/%s/policy", {"step_wise"}, .nodes = NODES_THERMAL},
+
+    // Do not Disturb and battery saver module
+    {NULL, {NULL, "1", "0", "0"}, .action = ACTION_DND},
+    {"/sys/module/battery_saver/parameters/enabled", {NULL, "0", "0", "1"}, .action = ACTION_BATTERY_SAVER},
+    {"/sys/module/workqueue/parameters/power_efficient", {NULL, "N", "N", "Y"}},
+
+    // Network tweak
+    {"/proc/sys/net/ipv4/tcp_fin_timeout", {NULL, "15", "15", "25"}},
+    {"/proc/sys/net/ipv4/tcp_low_latency", {NULL, "1", "1", "0"}},
+    {"/proc/sys/net/ipv4/tcp_slow_start_after_idle", {NULL, "0", "1", "1"}},
+    {"/proc/sys/net/ipv4/tcp_timestamps", {NULL, "0", "1", "0"}},
+
+    // Split lock mitigation
+    {"/proc/sys/kernel/split_lock_mitigate", {NULL, "0", "1", "1"}},
+
+    // VM Writeback Control
+    {"/proc/sys/vm/dirty_background_ratio", {NULL, "5", "10", "20"}},
+    {"/proc/sys/vm/dirty_ratio", {NULL, "15", "25", "40"}},
+    {"/proc/sys/vm/dirty_expire_centisecs", {NULL, "1500", "3000", "6000"}},
+    {"/proc/sys/vm/dirty_writeback_centisecs", {NULL, "1500", "3000", "6000"}},
+
+    // Sched Boost and real time latencies
+    {"/proc/sys/kernel/sched_boost", {NULL, "2", "1", "0"}},
+    {"/proc/sys/kernel/sched_nr_migrate", {NULL, "32", "16", "8"}},
+
+    // Tweaking scheduler
+    {"/proc/sys/kernel/sched_min_task_util_for_boost", {NULL, "15", "25", "45"}},
+    {"/proc/sys/kernel/sched_min_task_util_for_colocation", {NULL, "8", "15", "30"}},
+    {"/proc/sys/kernel/sched_migration_cost_ns", {NULL, "50000", "100000", "200000"}},
+    {"/proc/sys/kernel/sched_min_granularity_ns", {NULL, "800000", "1200000", "2000000"}},
+    {"/proc/sys/kernel/sched_wakeup_granularity_ns", {NULL, "900000", "2000000", "3000000"}},
+    {"/sys/kernel/debug/sched_features", {NULL, "NEXT_BUDDY", "NEXT_BUDDY", "NO_NEXT_BUDDY"}},
+    {"/sys/kernel/debug/sched_features", {NULL, "NO_TTWU_QUEUE", "TTWU_QUEUE", "TTWU_QUEUE"}},
+    {"/dev/stune/top-app/schedtune.prefer_idle", {NULL, "1", "0", "1"}},
+    {"/dev/stune/top-app/schedtune.boost", {NULL, "1", "1", "0"}},
+
+    // Oppo/Oplus/Realme Touchpanel
+    {"/proc/touchpanel/game_switch_enable", {NULL, "1", "0", "0"}},
+    {"/proc/touchpanel/oplus_tp_limit_enable", {NULL, "0", "1", "1"}},
+    {"/proc/touchpanel/oppo_tp_limit_enable", {NULL, "0", "1", "1"}},
+    {"/proc/touchpanel/oplus_tp_direction", {NULL, "1", "0", "0"}},
+    {"/proc/touchpanel/oppo_tp_direction", {NULL, "1", "0", "0"}},
+
+    // Memory tweak
+    {"/proc/sys/vm/swappiness", {NULL, "20", "40", "60"}},
+    {"/proc/sys/vm/vfs_cache_pressure", {NULL, "60", "80", "100"}},
+    {"/proc/sys/vm/compaction_proactiveness", {NULL, "30", "40", "10"}},
+
+    // eMMC and UFS frequency
+    {"/sys/class/devfreq/%s", {NULL, "max:max", "min:max", "min:min", "mid:max"}, devfreq_range,
+     .nodes = NODES_DEVFREQ, .roles = DEVFREQ_STORAGE, .unlock = UNLOCK(PROFILER_NORMAL)},
+
+    // CPU governor and frequency
+    {NULL, {NULL, "1", "1", "1"}, .action = ACTION_CPU},
+
+    // I/O Tweaks, internal storage is tuned where it holds /data and game assets
+    {"/sys/block/%s/queue/read_ahead_kb", {NULL, "32", "128", "128"}, .nodes = NODES_BLOCK,
+     .roles = BLOCK_UFS | BLOCK_NVME, .flags = RULE_DATA_DEVICE},
+    {"/sys/block/%s/queue/nr_requests", {NULL, "32", "64", "64"}, .nodes = NODES_BLOCK,
+     .roles = BLOCK_UFS | BLOCK_NVME, .flags = RULE_DATA_DEVICE},
+    {"/sys/block/%s/queue/scheduler", {NULL, "none", "mq-deadline kyber", "mq-deadline kyber"},
+     .nodes = NODES_BLOCK, .roles = BLOCK_UFS | BLOCK_NVME, .flags = RULE_DATA_DEVICE | RULE_PREFER},
+    {"/sys/block/%s/queue/read_ahead_kb", {NULL, "32", "64", "16"}, .nodes = NODES_BLOCK, .roles = BLOCK_EMMC,
+     .flags = RULE_DATA_DEVICE},
+    {"/sys/block/%s/queue/nr_requests", {NULL, "32", "64", "16"}, .nodes = NODES_BLOCK, .roles = BLOCK_EMMC,
+     .flags = RULE_DATA_DEVICE},
+
+    // SD cards
+    {"/sys/block/%s/queue/read_ahead_kb", {NULL, "32", "64", "16"}, .nodes = NODES_BLOCK, .roles = BLOCK_SD},
+    {"/sys/block/%s/queue/nr_requests", {NULL, "32", "64", "16"}, .nodes = NODES_BLOCK, .roles = BLOCK_SD},
+
+    // MediaTek PPM policies
+    {NULL, {NULL, "0", "1"}, .socs = SOC(SOC_MEDIATEK), .action = ACTION_PPM_POLICY},
+
+    // MediaTek FPSGO
+    {"/sys/kernel/fpsgo/common/force_onoff", {NULL, "0", "2", "0"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/sys/pnpmgr/fpsgo_boost/boost_enable", {NULL, "1", "1", "0"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/sys/module/mtk_fpsgo/parameters/perfmgr_enable", {NULL, "1", "1", "1"}, .socs = SOC(SOC_MEDIATEK)},
+
+    // MediaTek Power and CCI mode
+    {"/proc/cpufreq/cpufreq_cci_mode", {NULL, "1", "0"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/proc/cpufreq/cpufreq_power_mode", {NULL, "3", "0", "1"}, .socs = SOC(SOC_MEDIATEK)},
+
+    // MediaTek Perf limiter, DDR Boost mode and EAS/HMP Switch
+    {"/proc/perfmgr/syslimiter/syslimiter_force_disable", {NULL, "1", "0"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/sys/devices/platform/boot_dramboost/dramboost/dramboost", {NULL, "1", "0", "1"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/sys/devices/system/cpu/eas/enable", {NULL, "0", "2", "1"}, .socs = SOC(SOC_MEDIATEK)},
+
+    // MediaTek GED KPI and GED core
+    {"/sys/module/sspm_v3/holders/ged/parameters/is_GED_KPI_enabled", {NULL, "0", "1"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/sys/module/ged/parameters/gpu_dvfs_enable", {NULL, "1", "1"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/sys/module/ged/parameters/is_GED_KPI_enabled", {NULL, "0", "1"}, .socs = SOC(SOC_MEDIATEK)},
+
+    // MediaTek GPU Frequency
+    {NULL, {NULL, "1", "1", "1"}, .socs = SOC(SOC_MEDIATEK), .action = ACTION_MTK_GPU},
+
+    // MediaTek GPU Power limiter
+    {"/proc/gpufreq/gpufreq_power_limited", {NULL, "ignore_batt_oc 1", "ignore_batt_oc 0"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/proc/gpufreq/gpufreq_power_limited", {NULL, "ignore_batt_percent 1", "ignore_batt_percent 0"},
+     .socs = SOC(SOC_MEDIATEK)},
+    {"/proc/gpufreq/gpufreq_power_limited", {NULL, "ignore_low_batt 1", "ignore_low_batt 0"}, .socs = SOC(SOC_MEDIATEK)},
+    {"/proc/gpufreq/gpufreq_power_limited", {NULL, "ignore_thermal_protect 1", "ignore_thermal_protect 0"},
+     .socs = SOC(SOC_MEDIATEK)},
+    {"/proc/gpufreq/gpufreq_power_limited", {NULL, "ignore_pbm_limited 1", "ignore_pbm_limited 0"},
+     .socs = SOC(SOC_MEDIATEK)},
+
+    // MediaTek battery current limiter
+    {"/proc/mtk_batoc_throttling/battery_oc_protect_stop", {NULL, "stop 1", "stop 0"}, .socs = SOC(SOC_MEDIATEK)},
+
+    // MediaTek DRAM Frequency
+    {"/sys/devices/platform/10012000.dvfsrc/helio-dvfsrc/dvfsrc_req_ddr_opp", {NULL, "0", "-1", NULL, "-1"},
+     .socs = SOC(SOC_MEDIATEK), .unlock = UNLOCK(PROFILER_NORMAL)},
+    {"/sys/kernel/helio-dvfsrc/dvfsrc_force_vcore_dvfs_opp", {NULL, "0", "-1", NULL, "-1"}, .socs = SOC(SOC_MEDIATEK),
+     .unlock = UNLOCK(PROFILER_NORMAL)},
+    {"/sys/class/devfreq/mtk-dvfsrc-devfreq", {NULL, "max:max", "min:max", NULL, "mid:max"}, devfreq_range,
+     .socs = SOC(SOC_MEDIATEK), .unlock = UNLOCK(PROFILER_NORMAL)},
+
+    // MediaTek Eara Thermal
+    {"/sys/kernel/eara_thermal/enable", {NULL, "0", "1"}, .socs = SOC(SOC_MEDIATEK)},
+
+    // Qualcomm CPU Bus and DRAM frequencies
+    {"/sys/class/devfreq/%s", {NULL, "max:max", "min:max", NULL, "mid:max"}, devfreq_range,
+     .socs = SOC(SOC_SNAPDRAGON), .nodes = NODES_DEVFREQ, .roles = DEVFREQ_DDR | DEVFREQ_LLCC | DEVFREQ_CPU_LAT,
+     .flags = RULE_NO_MITIGATION, .unlock = UNLOCK(PROFILER_NORMAL)},
+    {"/sys/devices/system/cpu/bus_dcvs/DDR", {NULL, "max:max", "min:max", NULL, "mid:max"}, bus_dcvs_range,
+     .socs = SOC(SOC_SNAPDRAGON), .flags = RULE_NO_MITIGATION, .unlock = UNLOCK(PROFILER_NORMAL)},
+    {"/sys/devices/system/cpu/bus_dcvs/LLCC", {NULL, "max:max", "min:max", NULL, "mid:max"}, bus_dcvs_range,
+     .socs = SOC(SOC_SNAPDRAGON), .flags = RULE_NO_MITIGATION, .unlock = UNLOCK(PROFILER_NORMAL)},
+    {"/sys/devices/system/cpu/bus_dcvs/L3", {NULL, "max:max", "min:max", NULL, "mid:max"}, bus_dcvs_range,
+     .socs = SOC(SOC_SNAPDRAGON), .flags = RULE_NO_MITIGATION, .unlock = UNLOCK(PROFILER_NORMAL)},
+
+    // Adreno GPU
+    {"/sys/class/kgsl/kgsl-3d0/devfreq", {NULL, "max:max", "min:max", "min:min", "mid:max"}, devfreq_range,
+     .socs = SOC(SOC_SNAPDRAGON), .unlock = UNLOCK(PROFILER_NORMAL)},
+    {"/sys/class/kgsl/kgsl-3d0/bus_split", {NULL, "0", "1", "1"}, .socs = SOC(SOC_SNAPDRAGON)},
+    {"/sys/class/kgsl/kgsl-3d0/force_clk_on", {NULL, "1", "0", "0"}, .socs = SOC(SOC_SNAPDRAGON)},
+    {"/sys/class/kgsl/kgsl-3d0/perfcounter", {NULL, "0", "0", "0"}, .socs = SOC(SOC_SNAPDRAGON)},
+    {"/sys/class/kgsl/kgsl-3d0/devfreq/adrenoboost", {NULL, "1", "0", "0"}, .socs = SOC(SOC_SNAPDRAGON)},
+
+    // Exynos GPU
+    {"/sys/kernel/gpu", {NULL, "max:max", "min:max", "min:min", "mid:max"}, exynos_gpu_range,
+     .socs = SOC(SOC_EXYNOS), .unlock = UNLOCK(PROFILER_NORMAL)},
+    {"/sys/devices/platform/%s/power_policy", {NULL, "always_on", "coarse_demand"}, .socs = SOC(SOC_EXYNOS),
+     .nodes = NODES_MALI},
+
+    // Tensor GPU
+    {"/sys/devices/platform/%s", {NULL, "max:max", "min:max", "min:min", "mid:max"}, mali_range,
+     .socs = SOC(SOC_TENSOR), .nodes = NODES_MALI, .unlock = UNLOCK(PROFILER_NORMAL)},
+
+    // Exynos and Tensor DRAM frequency
+    {"/sys/class/devfreq/%s", {NULL, "max:max", "min:max", NULL, "mid:max"}, devfreq_range,
+     .socs = SOC(SOC_EXYNOS) | SOC(SOC_TENSOR), .nodes = NODES_DEVFREQ, .roles = DEVFREQ_DDR,
+     .flags = RULE_NO_MITIGATION, .unlock = UNLOCK(PROFILER_NORMAL)},
+
+    // Unisoc GPU
+    {"/sys/class/devfreq/%s", {NULL, "max:max", "min:max", "min:min", "mid:max"}, devfreq_range,
+     .socs = SOC(SOC_UNISOC), .nodes = NODES_DEVFREQ, .roles = DEVFREQ_GPU, .flags = RULE_FIRST_NODE,
+     .unlock = UNLOCK(PROFILER_NORMAL)},
+
+    // Drop caches
+    {"/proc/sys/vm/drop_caches", {NULL, "3"}, .flags = RULE_ALWAYS},
+};
+
+const size_t profile_rule_count = sizeof(profile_rules) / sizeof(profile_rules[0]);
@@ -0,0 +1,541 @@
+/*
+ * Copyright (C) 2025-2026 VelocityFox22
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <topology.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <nusantara_profiler.h>
+#include <proc_parse.h>
+#include <profile_table.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TOPOLOGY_FILE "/data/adb/.config/Nusantara/topology"
+#define TOPOLOGY_MAGIC 0x504f544e // "NTOP"
+#define TOPOLOGY_VERSION 2
+#define BOOT_ID_LEN 40
+#define TOPOLOGY_PATH_LEN 256
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t rules_hash;
+    char boot_id[BOOT_ID_LEN];
+} TopologyHeader;
+
+// Devfreq name substrings and the roles they imply
+static const struct {
+    const char* match;
+    uint8_t roles;
+} devfreq_roles[] = {
+    {".ufshc|mmc", DEVFREQ_STORAGE},
+    {".gpu|kgsl-3d0|.mali", DEVFREQ_GPU},
+    {"bus_ddr|cpubw|cpu-bw|kgsl-ddr-qos|devfreq_mif", DEVFREQ_DDR},
+    {"llccbw|bus_llcc", DEVFREQ_LLCC},
+    {"cpu-lat|memlat", DEVFREQ_CPU_LAT},
+};
+
+static Topology topology;
+static bool topology_ready = false;
+
+// Sysfs probes, resolved under sysroot
+static bool node_exists(const char* path) {
+    char buf[TOPOLOGY_PATH_LEN];
+    return access(knob_path(path, buf, sizeof(buf)), F_OK) == 0;
+}
+
+static int read_node(const char* path, char* value, size_t size) {
+    char buf[TOPOLOGY_PATH_LEN];
+    return read_node_string(knob_path(path, buf, sizeof(buf)), value, size);
+}
+
+/***********************************************************************************
+ * Function Name      : node_matches
+ * Inputs             : name (const char *) - node name
+ *                      match (const char *) - '|' separated substrings, NULL for all
+ * Returns            : bool - true if name contains any of the substrings
+ ***********************************************************************************/
+bool node_matches(const char* name, const char* match) {
+    if (!match)
+        return true;
+
+    size_t name_len = strlen(name);
+    while (*match) {
+        size_t len = strcspn(match, "|");
+        if (len && memmem(name, name_len, match, len))
+            return true;
+        match += len;
+        if (*match == '|')
+            match++;
+    }
+    return false;
+}
+
+/***********************************************************************************
+ * Function Name      : add_node
+ * Inputs             : set (NodeSet) - set being filled
+ * Returns            : char * - name slot of the new node, NULL if the index is full
+ * Note               : Sets are filled one after another so each stays contiguous.
+ ***********************************************************************************/
+static char* add_node(NodeSet set) {
+    if (topology.node_count >= TOPOLOGY_MAX_NODES)
+        return NULL;
+
+    if (!topology.sets[set].count)
+        topology.sets[set].start = topology.node_count;
+    topology.sets[set].count++;
+    return topology.names[topology.node_count++];
+}
+
+/***********************************************************************************
+ * Function Name      : scan_nodes
+ * Inputs             : set (NodeSet) - set to fill
+ *                      dir_path (const char *) - directory to list
+ *                      pattern (const char *) - required substring, NULL for all
+ * Returns            : None
+ ***********************************************************************************/
+static void scan_nodes(NodeSet set, const char* dir_path, const char* pattern) {
+    char buf[TOPOLOGY_PATH_LEN];
+    topology.sets[set].start = topology.node_count;
+    DIR* dir = opendir(knob_path(dir_path, buf, sizeof(buf)));
+    if (!dir)
+        return;
+
+    struct dirent* ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (ent->d_name[0] == '.' || (pattern && !strstr(ent->d_name, pattern)))
+            continue;
+
+        char* name = add_node(set);
+        if (!name)
+            break;
+        snprintf(name, NODE_NAME_LEN, "%s", ent->d_name);
+    }
+    closedir(dir);
+}
+
+/***********************************************************************************
+ * Function Name      : parse_cpu_list
+ * Inputs             : list (const char *) - kernel cpu list, e.g. "0-3,6"
+ * Returns            : uint32_t - bitmask of the listed cpus
+ ***********************************************************************************/
+static uint32_t parse_cpu_list(const char* list) {
+    uint32_t mask = 0;
+    char* end;
+
+    while (*list) {
+        long first = strtol(list, &end, 10);
+        if (end == list)
+            break;
+
+        long last = first;
+        if (*end == '-')
+            last = strtol(end + 1, &end, 10);
+        for (long cpu = first; cpu <= last && cpu < 32; cpu++)
+            mask |= 1u << cpu;
+
+        list = end;
+        while (*list == ',' || *list == ' ')
+            list++;
+    }
+    return mask;
+}
+
+static int compare_policy(const void* a, const void* b) {
+    // "policyN", cluster numbering in PPM follows policy order
+    return atoi((const char*)a + 6) - atoi((const char*)b + 6);
+}
+
+/***********************************************************************************
+ * Function Name      : discover_cpufreq
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Index cpufreq dirs relative to /sys/devices/system/cpu with
+ *                      the cores behind each of them.
+ ***********************************************************************************/
+static void discover_cpufreq(void) {
+    char path[128];
+    char list[64];
+    NodeRange* set = &topology.sets[NODES_CPUFREQ];
+
+    scan_nodes(NODES_CPUFREQ, "/sys/devices/system/cpu/cpufreq", "policy");
+    if (set->count > TOPOLOGY_MAX_POLICIES) {
+        topology.node_count -= set->count - TOPOLOGY_MAX_POLICIES;
+        set->count = TOPOLOGY_MAX_POLICIES;
+    }
+    qsort(topology.names[set->start], set->count, NODE_NAME_LEN, compare_policy);
+
+    for (int i = 0; i < set->count; i++) {
+        char* name = topology.names[set->start + i];
+        int policy = atoi(name + 6);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpufreq/policy%d/related_cpus", policy);
+        read_node(path, list, sizeof(list));
+        topology.policy_cpus[i] = parse_cpu_list(list);
+        snprintf(name, NODE_NAME_LEN, "cpufreq/policy%d", policy);
+    }
+    if (set->count)
+        return;
+
+    // Kernels without policy dirs expose cpufreq per CPU only
+    read_node("/sys/devices/system/cpu/possible", list, sizeof(list));
+    uint32_t possible = parse_cpu_list(list);
+    for (int cpu = 0; cpu < 32 && set->count < TOPOLOGY_MAX_POLICIES; cpu++) {
+        if (!(possible & (1u << cpu)))
+            continue;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+        if (!node_exists(path))
+            continue;
+
+        char* name = add_node(NODES_CPUFREQ);
+        if (!name)
+            break;
+        snprintf(name, NODE_NAME_LEN, "cpu%d/cpufreq", cpu);
+        topology.policy_cpus[set->count - 1] = 1u << cpu;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : classify_block
+ * Inputs             : name (const char *) - /sys/block entry
+ * Returns            : uint8_t - BLOCK_* class, 0 for devices nothing should tune
+ ***********************************************************************************/
+static uint8_t classify_block(const char* name) {
+    char path[TOPOLOGY_PATH_LEN];
+    char value[16];
+
+    if (strncmp(name, "nvme", 4) == 0)
+        return BLOCK_NVME;
+
+    if (strncmp(name, "mmcblk", 6) == 0) {
+        // boot0, boot1 and rpmb are hardware partitions of an eMMC
+        if (strstr(name, "boot") || strstr(name, "rpmb"))
+            return 0;
+        snprintf(path, sizeof(path), "/sys/block/%s/device/type", name);
+        if (read_node(path, value, sizeof(value)) == PARSE_OK)
+            return strcmp(value, "SD") == 0 ? BLOCK_SD : BLOCK_EMMC;
+        snprintf(path, sizeof(path), "/sys/block/%s/removable", name);
+        return read_node(path, value, sizeof(value)) == PARSE_OK && value[0] == '1' ? BLOCK_SD : BLOCK_EMMC;
+    }
+
+    // UFS LUNs are SCSI disks, so is USB mass storage
+    if (strncmp(name, "sd", 2) == 0) {
+        char buf[TOPOLOGY_PATH_LEN];
+        char target[TOPOLOGY_PATH_LEN];
+        snprintf(path, sizeof(path), "/sys/block/%s", name);
+        ssize_t len = readlink(knob_path(path, buf, sizeof(buf)), target, sizeof(target) - 1);
+        if (len > 0) {
+            target[len] = '\0';
+            if (strstr(target, "/usb"))
+                return 0;
+        }
+        return BLOCK_UFS;
+    }
+
+    // zram, dm and loop sit on memory or other devices, tuning them does nothing useful
+    return 0;
+}
+
+/***********************************************************************************
+ * Function Name      : link_disk
+ * Inputs             : path (const char *) - /sys/dev/block or /sys/class/block link
+ *                      disk (char *) - receives /sys/block name of the whole disk
+ *                      size (size_t) - size of disk
+ * Returns            : bool - true if the link points into a block device
+ * Description        : Links end in ".../block/sda/sda12" for a partition and
+ *                      ".../block/dm-5" for a disk.
+ ***********************************************************************************/
+static bool link_disk(const char* path, char* disk, size_t size) {
+    char buf[TOPOLOGY_PATH_LEN];
+    char target[TOPOLOGY_PATH_LEN];
+    ssize_t len = readlink(knob_path(path, buf, sizeof(buf)), target, sizeof(target) - 1);
+    if (len <= 0)
+        return false;
+    target[len] = '\0';
+
+    char* name = NULL;
+    for (char* p = strstr(target, "/block/"); p; p = strstr(p + 1, "/block/"))
+        name = p + 7;
+    if (!name)
+        return false;
+    name[strcspn(name, "/")] = '\0';
+    snprintf(disk, size, "%s", name);
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : find_data_disk
+ * Inputs             : disk (char *) - receives /sys/block name holding /data
+ *                      size (size_t) - size of disk
+ * Returns            : bool - true if found
+ * Description        : Resolve the device mounted on /data from mountinfo, then
+ *                      follow dm slaves, e.g. metadata encryption, down to the disk.
+ ***********************************************************************************/
+static bool find_data_disk(char* disk, size_t size) {
+    char path[TOPOLOGY_PATH_LEN];
+    FILE* fp = fopen(knob_path("/proc/self/mountinfo", path, sizeof(path)), "re");
+    if (!fp)
+        return false;
+
+    // "<id> <parent> <major>:<minor> <root> <mount point> ...", the last mount is on top
+    char dev[32] = "";
+    char* line = NULL;
+    size_t line_size = 0;
+    while (getline(&line, &line_size, fp) != -1) {
+        char number[32];
+        char mount_point[16];
+        if (sscanf(line, "%*s %*s %31s %*s %15s", number, mount_point) == 2 && strcmp(mount_point, "/data") == 0)
+            snprintf(dev, sizeof(dev), "%s", number);
+    }
+    free(line);
+    fclose(fp);
+
+    snprintf(path, sizeof(path), "/sys/dev/block/%s", dev);
+    if (!dev[0] || !link_disk(path, disk, size))
+        return false;
+
+    for (int depth = 0; depth < 4; depth++) {
+        char buf[TOPOLOGY_PATH_LEN];
+        char slave[NODE_NAME_LEN] = "";
+        snprintf(path, sizeof(path), "/sys/block/%s/slaves", disk);
+        DIR* dir = opendir(knob_path(path, buf, sizeof(buf)));
+        if (!dir)
+            return true;
+
+        struct dirent* ent;
+        while ((ent = readdir(dir)) != NULL) {
+            if (ent->d_name[0] != '.') {
+                snprintf(slave, sizeof(slave), "%s", ent->d_name);
+                break;
+            }
+        }
+        closedir(dir);
+        if (!slave[0])
+            return true;
+
+        snprintf(path, sizeof(path), "/sys/class/block/%s", slave);
+        if (!link_disk(path, disk, size))
+            return false;
+    }
+    return true;
+}
+
+/***********************************************************************************
+ * Function Name      : discover_block
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Index physical block devices with their class. When /data
+ *                      can't be resolved every internal disk is assumed to hold it.
+ ***********************************************************************************/
+static void discover_block(void) {
+    NodeRange* set = &topology.sets[NODES_BLOCK];
+    scan_nodes(NODES_BLOCK, "/sys/block", NULL);
+
+    // Block set is the last one filled so far, drop devices in place
+    int kept = 0;
+    for (int i = 0; i < set->count; i++) {
+        int node = set->start + i;
+        uint8_t class = classify_block(topology.names[node]);
+        if (!class)
+            continue;
+        memmove(topology.names[set->start + kept], topology.names[node], NODE_NAME_LEN);
+        topology.roles[set->start + kept++] = class;
+    }
+    topology.node_count -= set->count - kept;
+    set->count = kept;
+
+    char disk[NODE_NAME_LEN];
+    bool found = false;
+    if (find_data_disk(disk, sizeof(disk))) {
+        for (int i = set->start; i < set->start + set->count; i++) {
+            if (strcmp(topology.names[i], disk) == 0) {
+                topology.roles[i] |= BLOCK_DATA;
+                found = true;
+            }
+        }
+    }
+    for (int i = set->start; !found && i < set->start + set->count; i++) {
+        if (topology.roles[i] & (BLOCK_UFS | BLOCK_EMMC | BLOCK_NVME))
+            topology.roles[i] |= BLOCK_DATA;
+    }
+}
+
+/***********************************************************************************
+ * Function Name      : discover_gpu
+ * Inputs             : None
+ * Returns            : GpuBackend - GPU frequency interface of the device
+ ***********************************************************************************/
+static GpuBackend discover_gpu(void) {
+    if (node_exists("/sys/class/kgsl/kgsl-3d0"))
+        return GPU_KGSL;
+    if (node_exists("/proc/gpufreqv2"))
+        return GPU_GPUFREQV2;
+    if (node_exists("/proc/gpufreq"))
+        return GPU_GPUFREQ;
+    if (node_exists("/sys/kernel/gpu"))
+        return GPU_EXYNOS;
+    if (topology.sets[NODES_MALI].count)
+        return GPU_MALI;
+    return GPU_UNKNOWN;
+}
+
+/***********************************************************************************
+ * Function Name      : discover_knobs
+ * Inputs             : None
+ * Returns            : None
+ * Description        : Mark profile rules whose knob exists. Node rules expand to
+ *                      discovered nodes and actions probe on their own, so only
+ *                      fixed paths are checked here.
+ ***********************************************************************************/
+static void discover_knobs(void) {
+    for (size_t i = 0; i < profile_rule_count && i < TOPOLOGY_MAX_RULES; i++) {
+        const KnobRule* rule = &profile_rules[i];
+        if (!rule->path || rule->nodes != NODES_NONE || node_exists(rule->path))
+            topology.knobs[i / 8] |= 1u << (i % 8);
+    }
+}
+
+static void topology_discover(void) {
+    memset(&topology, 0, sizeof(topology));
+
+    discover_cpufreq();
+    scan_nodes(NODES_DEVFREQ, "/sys/class/devfreq", NULL);
+    discover_block();
+    scan_nodes(NODES_THERMAL, "/sys/class/thermal", "thermal_zone");
+
+    // First Mali device is the GPU
+    scan_nodes(NODES_MALI, "/sys/devices/platform", ".mali");
+    if (topology.sets[NODES_MALI].count > 1) {
+        topology.node_count -= topology.sets[NODES_MALI].count - 1;
+        topology.sets[NODES_MALI].count = 1;
+    }
+
+    const NodeRange* devfreq = &topology.sets[NODES_DEVFREQ];
+    for (int i = devfreq->start; i < devfreq->start + devfreq->count; i++) {
+        for (size_t r = 0; r < sizeof(devfreq_roles) / sizeof(devfreq_roles[0]); r++) {
+            if (node_matches(topology.names[i], devfreq_roles[r].match))
+                topology.roles[i] |= devfreq_roles[r].roles;
+        }
+    }
+
+    topology.gpu = discover_gpu();
+    topology.has_ppm = node_exists("/proc/ppm");
+    discover_knobs();
+}
+
+static uint32_t hash_rules(void) {
+    // FNV-1a over rule paths, a module update reorders the knob bitmap
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < profile_rule_count; i++) {
+        const char* p = profile_rules[i].path ? profile_rules[i].path : "";
+        do {
+            hash = (hash ^ (unsigned char)*p) * 16777619u;
+        } while (*p++);
+    }
+    return hash ^ (uint32_t)profile_rule_count;
+}
+
+/***********************************************************************************
+ * Function Name      : topology_load
+ * Inputs             : header (const TopologyHeader *) - expected header
+ * Returns            : bool - true if a saved index of this boot was loaded
+ ***********************************************************************************/
+static bool topology_load(const TopologyHeader* header) {
+    char buf[TOPOLOGY_PATH_LEN];
+    int fd = open(knob_path(TOPOLOGY_FILE, buf, sizeof(buf)), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    TopologyHeader saved;
+    bool valid = read(fd, &saved, sizeof(saved)) == sizeof(saved) && memcmp(&saved, header, sizeof(saved)) == 0 &&
+                 read(fd, &topology, sizeof(topology)) == sizeof(topology);
+    close(fd);
+
+    // Never trust ranges from disk
+    for (int set = 0; valid && set < NODE_SETS; set++) {
+        const NodeRange* range = &topology.sets[set];
+        valid = topology.node_count <= TOPOLOGY_MAX_NODES && range->start + range->count <= topology.node_count;
+    }
+    valid = valid && topology.sets[NODES_CPUFREQ].count <= TOPOLOGY_MAX_POLICIES;
+    for (int i = 0; valid && i < topology.node_count; i++)
+        valid = memchr(topology.names[i], '\0', NODE_NAME_LEN) != NULL;
+    return valid;
+}
+
+/***********************************************************************************
+ * Function Name      : topology_save
+ * Inputs             : header (const TopologyHeader *) - header to store
+ * Returns            : None
+ * Description        : Replace the saved index atomically so a reader never sees
+ *                      a partial file.
+ ***********************************************************************************/
+static void topology_save(const TopologyHeader* header) {
+    char path[TOPOLOGY_PATH_LEN], tmp_path[TOPOLOGY_PATH_LEN];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", knob_path(TOPOLOGY_FILE, path, sizeof(path)));
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1)
+        return;
+
+    bool written = write(fd, header, sizeof(*header)) == sizeof(*header) &&
+                   write(fd, &topology, sizeof(topology)) == sizeof(topology);
+    if (close(fd) == 0 && written && rename(tmp_path, path) == 0)
+        return;
+    unlink(tmp_path);
+}
+
+/***********************************************************************************
+ * Function Name      : topology_get
+ * Inputs             : None
+ * Returns            : const Topology * - hardware index of this boot
+ * Description        : Sysfs layout only changes across boots, so discovery runs
+ *                      once per boot_id and later processes load the saved index.
+ ***********************************************************************************/
+const Topology* topology_get(void) {
+    if (topology_ready)
+        return &topology;
+
+    TopologyHeader header = {
+        .magic = TOPOLOGY_MAGIC,
+        .version = TOPOLOGY_VERSION,
+        .size = sizeof(Topology),
+        .rules_hash = hash_rules(),
+    };
+    read_node("/proc/sys/kernel/random/boot_id", header.boot_id, sizeof(header.boot_id));
+
+    if (!header.boot_id[0] || !topology_load(&header)) {
+        topology_discover();
+        if (header.boot_id[0] && !knob_is_dry_run())
+            topology_save(&header);
+    }
+
+    topology_ready = true;
+    return &topology;
+}
+
+/***********************************************************************************
+ * Function Name      : topology_knob_exists
+ * Inputs             : topology (const Topology *) - hardware index
+ *                      rule (size_t) - index into profile_rules
+ * Returns            : bool - false if the rule's knob is known to be missing
+ ***********************************************************************************/
+bool topology_knob_exists(const Topology* topology, size_t rule) {
+    if (rule >= TOPOLOGY_MAX_RULES)
+        return true;
+    return topology->knobs[rule / 8] & (1u << (rule % 8));
+}
@@ -0,0 +1,133 @@
+#!/bin/sh
+#
+# Copyright (C) 2025-2026 VelocityFox22
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+# Regression check for nusantara_profiler --sysroot on a plain Linux host
+# Usage: sysroot_roundtrip.sh <nusantara_profiler binary>
+#
+# Builds a small fake /sys and /proc/sys holding stock values. The daemon
+# starts with perfcommon then normal, which must leave knobs no profile
+# changed yet alone. Then it switches through every profile and restores. Each knob must read back its stock
+# value afterwards. Reads are compared the way the kernel would present
+# them: the trailing newline is ignored and "[x] y z" selectors read as x.
+
+PROFILER="$1"
+if [ ! -x "$PROFILER" ]; then
+	echo "Usage: $0 <nusantara_profiler binary>" >&2
+	exit 1
+fi
+
+ROOT=$(mktemp -d) || exit 1
+trap 'rm -rf "$ROOT"' EXIT
+CONFIG=/data/adb/.config/Nusantara
+FAILED=0
+
+node() {
+	mkdir -p "$(dirname "$ROOT$1")"
+	printf '%s\n' "$2" >"$ROOT$1"
+	chmod 0644 "$ROOT$1"
+}
+
+# Stock values of a generic device, longer than most tuned ones so a
+# write that doesn't replace the whole file shows up
+make_tree() {
+	rm -rf "${ROOT:?}"/*
+	node /proc/sys/kernel/random/boot_id "$(cat /proc/sys/kernel/random/boot_id)"
+	node /proc/sys/vm/swappiness 60
+	node /proc/sys/vm/vfs_cache_pressure 100
+	node /proc/sys/vm/dirty_ratio 20
+	node /proc/sys/vm/dirty_background_ratio 10
+	node /proc/sys/kernel/sched_migration_cost_ns 500000
+	node /proc/sys/kernel/sched_child_runs_first 0
+	node /sys/module/workqueue/parameters/power_efficient N
+	for policy in 0 4; do
+		dir=/sys/devices/system/cpu/cpufreq/policy$policy
+		node $dir/scaling_available_frequencies "300000 1000000 2000000"
+		node $dir/scaling_available_governors "schedutil performance powersave"
+		node $dir/scaling_governor schedutil
+		node $dir/scaling_min_freq 300000
+		node $dir/scaling_max_freq 2000000
+		node $dir/cpuinfo_min_freq 300000
+		node $dir/cpuinfo_max_freq 2000000
+	done
+	node /sys/block/sda/queue/read_ahead_kb 128
+	node /sys/block/sda/queue/nr_requests 64
+	node /sys/block/sda/queue/iostats 1
+	node /sys/block/sda/queue/add_random 1
+	node /sys/block/sda/queue/scheduler "[mq-deadline] kyber none"
+
+	node "$CONFIG/soc_recognition" 0
+	node "$CONFIG/lite_mode" 0
+	node "$CONFIG/device_mitigation" 0
+	node "$CONFIG/normal_baseline" 1
+	node "$CONFIG/default_cpu_gov" schedutil
+	node "$CONFIG/powersave_cpu_gov" powersave
+}
+
+# <path> <value> per knob, config and boot_id aren't knobs. Any byte left
+# over from an earlier longer value shows up in the od dump.
+snapshot() {
+	(cd "$ROOT" && find sys proc -type f ! -path '*/random/*' | sort | while read -r file; do
+		value=$(cat "$file")
+		case "$value" in
+		*\[*\]*) value=${value#*\[} value=${value%%\]*} ;;
+		esac
+		printf '%s %s\n' "$file" "$(printf '%s' "$value" | od -An -c | tr -s ' \n' ' ')"
+	done)
+}
+
+check() {
+	if [ "$2" = "$3" ]; then
+		echo "PASS: $1"
+	else
+		echo "FAIL: $1"
+		printf '%s\n' "$2" >"$ROOT/expected"
+		printf '%s\n' "$3" >"$ROOT/actual"
+		diff "$ROOT/expected" "$ROOT/actual"
+		FAILED=1
+	fi
+}
+
+# Snapshot lines of knobs missing from baseline file $2
+unknown_knobs() {
+	printf '%s\n' "$1" | while read -r file value; do
+		grep -q "^/$file " "$2" 2>/dev/null || printf '%s %s\n' "$file" "$value"
+	done
+}
+
+make_tree
+STOCK=$(snapshot)
+"$PROFILER" --sysroot "$ROOT" 0 >/dev/null || FAILED=1
+cp "$ROOT$CONFIG/baseline" "$ROOT/baseline.common" 2>/dev/null || : >"$ROOT/baseline.common"
+"$PROFILER" --sysroot "$ROOT" 2 >/dev/null || FAILED=1
+check "first normal apply leaves knobs unknown to the baseline alone" \
+	"$(unknown_knobs "$STOCK" "$ROOT/baseline.common")" "$(unknown_knobs "$(snapshot)" "$ROOT/baseline.common")"
+
+make_tree
+STOCK=$(snapshot)
+
+for mode in 0 1 2 3 1 2; do
+	"$PROFILER" --sysroot "$ROOT" "$mode" >/dev/null || FAILED=1
+done
+"$PROFILER" --sysroot "$ROOT" restore >/dev/null || FAILED=1
+check "apply and restore leaves every knob at its stock value" "$STOCK" "$(snapshot)"
+
+# A dry run after real runs must see what is in the tree, not leftovers
+"$PROFILER" --sysroot "$ROOT" 1 >/dev/null || FAILED=1
+PLAN=$("$PROFILER" --sysroot "$ROOT" --dry-run 1 | awk -F '\t' '$1 == "write" { print $2 }')
+check "dry run right after an apply has nothing left to write" "" "$PLAN"
+
+exit $FAILED